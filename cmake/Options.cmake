@@ -66,6 +66,7 @@ function(set_options)
     endif()
     option(OPTION_USE_NSIS "Use NSIS to create windows installer; enable only for stable releases" OFF)
     option(OPTION_TOOLS_ONLY "Build only tools target" OFF)
+    option(OPTION_ZONE_PROFILER "Build the fine-grained zone profiler (zone_profile console command)" OFF)
     option(OPTION_DOCS_ONLY "Build only docs target" OFF)
 
     if (OPTION_DOCS_ONLY)
@@ -84,6 +85,7 @@ function(show_options)
     message(STATUS "Option Use assert - ${OPTION_USE_ASSERTS}")
     message(STATUS "Option Use threads - ${OPTION_USE_THREADS}")
     message(STATUS "Option Use NSIS - ${OPTION_USE_NSIS}")
+    message(STATUS "Option Zone profiler - ${OPTION_ZONE_PROFILER}")
 endfunction()
 
 # Add the definitions for the options that are selected.
@@ -104,4 +106,8 @@ function(add_definitions_based_on_options)
     else()
         add_definitions(-DNDEBUG)
     endif()
+
+    if(OPTION_ZONE_PROFILER)
+        add_definitions(-DWITH_ZONE_PROFILER)
+    endif()
 endfunction()
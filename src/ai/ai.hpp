@@ -142,6 +142,8 @@ private:
 	static uint frame_counter;                      ///< Tick counter for the AI code
 	static class AIScannerInfo *scanner_info;       ///< ScriptScanner instance that is used to find AIs
 	static class AIScannerLibrary *scanner_library; ///< ScriptScanner instance that is used to find AI Libraries
+
+	static void ParallelGameLoop();
 };
 
 #endif /* AI_HPP */
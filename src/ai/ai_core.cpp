@@ -17,12 +17,19 @@
 #include "../framerate_type.h"
 #include "../scope_info.h"
 #include "../string_func.h"
+#include "../worker_thread.h"
+#include "../script/script_parallel.hpp"
 #include "ai_scanner.hpp"
 #include "ai_instance.hpp"
 #include "ai_config.hpp"
 #include "ai_info.hpp"
 #include "ai.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
 #include "../safeguards.h"
 
 /* static */ uint AI::frame_counter = 0;
@@ -78,6 +85,11 @@
 	assert(_settings_game.difficulty.competitor_speed <= 4);
 	if ((AI::frame_counter & ((1 << (4 - _settings_game.difficulty.competitor_speed)) - 1)) != 0) return;
 
+	if (_settings_client.gui.parallel_ai_scripts) {
+		AI::ParallelGameLoop();
+		return;
+	}
+
 	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
 	for (const Company *c : Company::Iterate()) {
 		if (c->is_ai) {
@@ -85,11 +97,7 @@
 			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
 			cur_company.Change(c->index);
 			c->ai_instance->GameLoop();
-			/* Occasionally collect garbage; every 255 ticks do one company.
-			 * Effectively collecting garbage once every two months per AI. */
-			if ((AI::frame_counter & 255) == 0 && (CompanyID)GB(AI::frame_counter, 8, 4) == c->index) {
-				c->ai_instance->CollectGarbage();
-			}
+			c->ai_instance->CollectGarbageIfDue();
 		} else {
 			PerformanceMeasurer::SetInactive((PerformanceElement)(PFE_AI0 + c->index));
 		}
@@ -97,6 +105,85 @@
 	cur_company.Restore();
 }
 
+/** State shared between the threads resuming the VMs of AIs in parallel. */
+struct AIParallelResumeState {
+	std::vector<CompanyID> companies;       ///< Companies whose AI VM is to be resumed
+	std::atomic<uint> next_index;           ///< Index into companies of the next AI to resume
+	uint helpers_active;                    ///< Number of helper jobs which have not yet finished, protected by lock
+	std::mutex lock;                        ///< Lock for helpers_active
+	std::condition_variable done_cv;        ///< Notified when the last helper job finishes
+
+	/** Resume AI VMs until there are none left. */
+	void Run()
+	{
+		for (uint i = this->next_index++; i < (uint)this->companies.size(); i = this->next_index++) {
+			const Company *c = Company::Get(this->companies[i]);
+			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
+			c->ai_instance->ResumeParallelGameLoop();
+		}
+	}
+};
+
+/**
+ * Run the AIs of all companies, with the Squirrel VMs resumed in parallel.
+ * Calls from the scripts into the game are serialised, and any DoCommands they
+ * make are only tested against the state at the start of the tick. Once all
+ * VMs have been suspended, the commands are executed in company order.
+ */
+/* static */ void AI::ParallelGameLoop()
+{
+	AIParallelResumeState state;
+
+	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
+	for (const Company *c : Company::Iterate()) {
+		if (c->is_ai) {
+			SCOPE_INFO_FMT([&], "AI::ParallelGameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName(), c->ai_info->GetVersion());
+			cur_company.Change(c->index);
+			if (c->ai_instance->PrepareParallelGameLoop()) state.companies.push_back(c->index);
+		} else {
+			PerformanceMeasurer::SetInactive((PerformanceElement)(PFE_AI0 + c->index));
+		}
+	}
+
+	if (!state.companies.empty()) {
+		state.next_index = 0;
+		state.helpers_active = (uint)state.companies.size() - 1;
+
+		_script_parallel_active = true;
+		for (uint i = 1; i < (uint)state.companies.size(); i++) {
+			_general_worker_pool.EnqueueJob([](void *data1, void *data2, void *data3) {
+				AIParallelResumeState *state = static_cast<AIParallelResumeState *>(data1);
+				state->Run();
+				std::lock_guard<std::mutex> lk(state->lock);
+				if (--state->helpers_active == 0) state->done_cv.notify_all();
+			}, &state);
+		}
+		state.Run();
+		{
+			std::unique_lock<std::mutex> lk(state.lock);
+			state.done_cv.wait(lk, [&]() { return state.helpers_active == 0; });
+		}
+		_script_parallel_active = false;
+
+		for (CompanyID cid : state.companies) {
+			/* Commands of an earlier AI may have stopped this AI, or removed the company */
+			const Company *c = Company::GetIfValid(cid);
+			if (c == nullptr || !c->is_ai || c->ai_instance == nullptr) continue;
+			SCOPE_INFO_FMT([&], "AI::ParallelGameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName(), c->ai_info->GetVersion());
+			cur_company.Change(c->index);
+			c->ai_instance->FinishParallelGameLoop();
+		}
+	}
+
+	for (const Company *c : Company::Iterate()) {
+		if (c->is_ai) {
+			cur_company.Change(c->index);
+			c->ai_instance->CollectGarbageIfDue();
+		}
+	}
+	cur_company.Restore();
+}
+
 /* static */ uint AI::GetTick()
 {
 	return AI::frame_counter;
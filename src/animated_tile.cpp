@@ -15,13 +15,62 @@
 #include "viewport_func.h"
 #include "framerate_type.h"
 #include "date_func.h"
+#include "string_func.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 
+#include <array>
+#include <vector>
+
 #include "safeguards.h"
 
 /** The table/list with animated tiles. */
 btree::btree_map<TileIndex, AnimatedTileInfo> _animated_tiles;
 
+/** Number of animation speed buckets, speeds above the highest bucket speed are never due, see AnimateAnimatedTiles() */
+static const uint ANIMATED_TILE_SPEED_BUCKETS = 34;
+
+/**
+ * Tiles of one animation speed, so that each tick only the buckets which are due need to be visited.
+ * Entries whose _animated_tiles entry has been deleted or has changed speed are removed lazily when the bucket is next animated.
+ */
+struct AnimatedTileBucket {
+	std::vector<TileIndex> tiles; ///< Tiles, sorted and unique unless sort_needed
+	bool sort_needed = false;     ///< Whether tiles have been appended since the bucket was last sorted
+};
+
+static std::array<AnimatedTileBucket, ANIMATED_TILE_SPEED_BUCKETS> _animated_tile_buckets;
+
+/** Tiles marked as pending deletion since the last call to AnimateAnimatedTiles(), these are removed from _animated_tiles regardless of whether their bucket is due. */
+static std::vector<TileIndex> _animated_tiles_pending_deletion;
+
+static inline AnimatedTileBucket &GetAnimatedTileBucket(uint8 speed)
+{
+	return _animated_tile_buckets[std::min<uint>(speed, ANIMATED_TILE_SPEED_BUCKETS - 1)];
+}
+
+static void AddToAnimatedTileBucket(TileIndex tile, uint8 speed)
+{
+	AnimatedTileBucket &bucket = GetAnimatedTileBucket(speed);
+	bucket.tiles.push_back(tile);
+	bucket.sort_needed = true;
+}
+
+/**
+ * Rebuild the speed buckets from _animated_tiles, after it has been modified directly (e.g. when loading).
+ */
+void RebuildAnimatedTileBuckets()
+{
+	for (AnimatedTileBucket &bucket : _animated_tile_buckets) {
+		bucket.tiles.clear();
+		bucket.sort_needed = false;
+	}
+	_animated_tiles_pending_deletion.clear();
+	for (const auto &it : _animated_tiles) {
+		GetAnimatedTileBucket(it.second.speed).tiles.push_back(it.first);
+		if (it.second.pending_deletion) _animated_tiles_pending_deletion.push_back(it.first);
+	}
+}
+
 /**
  * Removes the given tile from the animated tile table.
  * @param tile the tile to remove
@@ -31,6 +80,7 @@ void DeleteAnimatedTile(TileIndex tile)
 	auto to_remove = _animated_tiles.find(tile);
 	if (to_remove != _animated_tiles.end() && !to_remove->second.pending_deletion) {
 		to_remove->second.pending_deletion = true;
+		_animated_tiles_pending_deletion.push_back(tile);
 		MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 	}
 }
@@ -73,9 +123,16 @@ static void UpdateAnimatedTileSpeed(TileIndex tile, AnimatedTileInfo &info)
 void AddAnimatedTile(TileIndex tile, bool mark_dirty)
 {
 	if (mark_dirty) MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
-	AnimatedTileInfo &info = _animated_tiles[tile];
+	auto result = _animated_tiles.insert({ tile, AnimatedTileInfo() });
+	AnimatedTileInfo &info = result.first->second;
+	const uint8 old_speed = info.speed;
 	UpdateAnimatedTileSpeed(tile, info);
 	info.pending_deletion = false;
+
+	/* An existing entry is still in the bucket of its old speed, duplicates are removed when the bucket is sorted. */
+	if (result.second || &GetAnimatedTileBucket(old_speed) != &GetAnimatedTileBucket(info.speed)) {
+		AddToAnimatedTileBucket(tile, info.speed);
+	}
 }
 
 int GetAnimatedTileSpeed(TileIndex tile)
@@ -89,6 +146,7 @@ int GetAnimatedTileSpeed(TileIndex tile)
 
 /**
  * Animate all tiles in the animated tile list, i.e.\ call AnimateTile on them.
+ * Tiles with speed N are animated every 2^N ticks, buckets are processed in order of increasing speed, and tiles in order of increasing tile index.
  */
 void AnimateAnimatedTiles()
 {
@@ -102,15 +160,40 @@ void AnimateAnimatedTiles()
 	const uint32 ticks = (uint) _scaled_tick_counter;
 	const uint8 max_speed = (ticks == 0) ? 32 : FindFirstBit(ticks);
 
-	auto iter = _animated_tiles.begin();
-	while (iter != _animated_tiles.end()) {
-		if (iter->second.pending_deletion) {
-			iter = _animated_tiles.erase(iter);
-			continue;
+	/* Remove tiles which were deleted since the last tick, also from buckets which are not due (and may never be, for speeds above 32). */
+	for (TileIndex tile : _animated_tiles_pending_deletion) {
+		auto iter = _animated_tiles.find(tile);
+		if (iter == _animated_tiles.end() || !iter->second.pending_deletion) continue;
+		const uint8 speed = iter->second.speed;
+		_animated_tiles.erase(iter);
+		if (speed > max_speed) {
+			AnimatedTileBucket &bucket = GetAnimatedTileBucket(speed);
+			bucket.tiles.erase(std::remove(bucket.tiles.begin(), bucket.tiles.end(), tile), bucket.tiles.end());
 		}
+	}
+	_animated_tiles_pending_deletion.clear();
+
+	for (uint8 speed = 0; speed <= max_speed; speed++) {
+		AnimatedTileBucket &bucket = _animated_tile_buckets[speed];
+		if (bucket.sort_needed) {
+			std::sort(bucket.tiles.begin(), bucket.tiles.end());
+			bucket.tiles.erase(std::unique(bucket.tiles.begin(), bucket.tiles.end()), bucket.tiles.end());
+			bucket.sort_needed = false;
+		}
+
+		/* Animating a tile may append to this bucket, only visit the tiles which were present at the start. */
+		const size_t count = bucket.tiles.size();
+		size_t kept = 0;
+		for (size_t i = 0; i < count; i++) {
+			const TileIndex curr = bucket.tiles[i];
+			auto iter = _animated_tiles.find(curr);
+			if (iter == _animated_tiles.end() || &GetAnimatedTileBucket(iter->second.speed) != &bucket) continue;
+			if (iter->second.pending_deletion) {
+				_animated_tiles.erase(iter);
+				continue;
+			}
+			bucket.tiles[kept++] = curr;
 
-		if (iter->second.speed <= max_speed) {
-			const TileIndex curr = iter->first;
 			switch (GetTileType(curr)) {
 				case MP_HOUSE:
 					AnimateTile_Town(curr);
@@ -132,7 +215,9 @@ void AnimateAnimatedTiles()
 					NOT_REACHED();
 			}
 		}
-		++iter;
+		if (kept != count) {
+			bucket.tiles.erase(bucket.tiles.begin() + kept, bucket.tiles.begin() + count);
+		}
 	}
 }
 
@@ -147,6 +232,7 @@ void UpdateAllAnimatedTileSpeeds()
 		UpdateAnimatedTileSpeed(iter->first, iter->second);
 		++iter;
 	}
+	RebuildAnimatedTileBuckets();
 }
 
 /**
@@ -155,4 +241,27 @@ void UpdateAllAnimatedTileSpeeds()
 void InitializeAnimatedTiles()
 {
 	_animated_tiles.clear();
+	RebuildAnimatedTileBuckets();
+}
+
+/**
+ * Write the number of animated tiles of each animation speed.
+ * @param b Buffer to write to.
+ * @param last Last valid byte of buffer.
+ * @return New end of buffer.
+ */
+char *DumpAnimatedTileStats(char *b, const char *last)
+{
+	std::array<uint, ANIMATED_TILE_SPEED_BUCKETS> counts = {};
+	for (const auto &it : _animated_tiles) {
+		if (!it.second.pending_deletion) counts[std::min<uint>(it.second.speed, ANIMATED_TILE_SPEED_BUCKETS - 1)]++;
+	}
+
+	b += seprintf(b, last, "animated tiles       %20u\n", (uint)_animated_tiles.size());
+	for (uint speed = 0; speed < ANIMATED_TILE_SPEED_BUCKETS; speed++) {
+		if (counts[speed] == 0) continue;
+		b += seprintf(b, last, "  speed %2u%s         %20u (bucket size: %u)\n", speed, speed == ANIMATED_TILE_SPEED_BUCKETS - 1 ? "+" : " ",
+				counts[speed], (uint)_animated_tile_buckets[speed].tiles.size());
+	}
+	return b;
 }
@@ -17,5 +17,7 @@ void DeleteAnimatedTile(TileIndex tile);
 void AnimateAnimatedTiles();
 void UpdateAllAnimatedTileSpeeds();
 void InitializeAnimatedTiles();
+void RebuildAnimatedTileBuckets();
+char *DumpAnimatedTileStats(char *b, const char *last);
 
 #endif /* ANIMATED_TILE_FUNC_H */
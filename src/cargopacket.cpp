@@ -94,6 +94,8 @@ void DumpCargoPacketDeferredPaymentStats(char *buffer, const char *last)
 		}
 	}
 	buffer += seprintf(buffer, last, "Deferred payment count: %u\n", (uint) _cargo_packet_deferred_payments.size());
+	buffer += seprintf(buffer, last, "Cargo packets: %u in use, %u allocated, %u bytes each\n",
+			(uint) CargoPacket::GetNumItems(), (uint) _cargopacket_pool.GetAllocatedItemCapacity(), (uint) sizeof(CargoPacket));
 }
 
 /**
@@ -117,13 +119,13 @@ CargoPacket::CargoPacket()
  * that, in contrary to all other pools, does not memset to 0.
  */
 CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16 count, SourceType source_type, SourceID source_id) :
+	source_xy(source_xy),
 	feeder_share(0),
+	loaded_at_xy(0),
 	count(count),
 	days_in_transit(0),
 	source_id(source_id),
-	source(source),
-	source_xy(source_xy),
-	loaded_at_xy(0)
+	source(source)
 {
 	dbg_assert(count != 0);
 	this->source_type  = source_type;
@@ -144,13 +146,13 @@ CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16 count, So
  * that, in contrary to all other pools, does not memset to 0.
  */
 CargoPacket::CargoPacket(uint16 count, uint16 days_in_transit, StationID source, TileIndex source_xy, TileIndex loaded_at_xy, Money feeder_share, SourceType source_type, SourceID source_id) :
+		source_xy(source_xy),
 		feeder_share(feeder_share),
+		loaded_at_xy(loaded_at_xy),
 		count(count),
 		days_in_transit(days_in_transit),
 		source_id(source_id),
-		source(source),
-		source_xy(source_xy),
-		loaded_at_xy(loaded_at_xy)
+		source(source)
 {
 	dbg_assert(count != 0);
 	this->source_type = source_type;
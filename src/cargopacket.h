@@ -52,18 +52,19 @@ void ChangeOwnershipOfCargoPacketDeferredPayments(Owner old_owner, Owner new_own
  */
 struct CargoPacket : CargoPacketPool::PoolItem<&_cargopacket_pool> {
 private:
-	Money feeder_share;     ///< Value of feeder pickup to be paid for on delivery of cargo.
-	uint16 count;           ///< The amount of cargo in this packet.
-	uint16 days_in_transit; ///< Amount of days this packet has been in transit.
-	SourceType source_type; ///< Type of \c source_id.
-	SourceID source_id;     ///< Index of source, INVALID_SOURCE if unknown/invalid.
-	StationID source;       ///< The station where the cargo came from first.
+	/* Members are ordered to avoid padding, there can be many millions of packets. */
 	TileIndex source_xy;    ///< The origin of the cargo (first station in feeder chain).
+	Money feeder_share;     ///< Value of feeder pickup to be paid for on delivery of cargo.
 	union {
 		TileOrStationID loaded_at_xy; ///< Location where this cargo has been loaded into the vehicle.
 		TileOrStationID next_station; ///< Station where the cargo wants to go next.
 	};
-	uint flags = 0;             ///< NOSAVE: temporary flags
+	uint16 count;           ///< The amount of cargo in this packet.
+	uint16 days_in_transit; ///< Amount of days this packet has been in transit.
+	SourceID source_id;     ///< Index of source, INVALID_SOURCE if unknown/invalid.
+	StationID source;       ///< The station where the cargo came from first.
+	SourceType source_type; ///< Type of \c source_id.
+	uint8 flags = 0;        ///< NOSAVE: temporary flags
 
 	/** Cargo packet flag bits in CargoPacket::flags. */
 	enum CargoPacketFlags {
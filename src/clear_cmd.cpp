@@ -243,20 +243,41 @@ static void UpdateFences(TileIndex tile)
 }
 
 
-/** Convert to or from snowy tiles. */
-static void TileLoopClearAlps(TileIndex tile)
+/**
+ * Get the snow level of a tile in the arctic climate.
+ * @param tile Tile to get the snow level of.
+ * @return Negative below the snow line, otherwise the snow density the tile should have (before clamping to 3).
+ */
+static int GetClearAlpsSnowLevel(TileIndex tile)
 {
-	int k;
 	int h = (int)TileHeight(tile);
 	if (h < GetSnowLine() - 1) {
 		/* Fast path to avoid needing to check all 4 corners */
-		k = -1;
+		return -1;
 	} else if (h >= GetSnowLine() + 4) {
 		/* Fast path to avoid needing to check all 4 corners */
-		k = 3;
+		return 3;
 	} else {
-		k = GetTileZ(tile) - GetSnowLine() + 1;
+		return GetTileZ(tile) - GetSnowLine() + 1;
 	}
+}
+
+/**
+ * Check whether TileLoopClearAlps would change a tile.
+ * @param tile Tile to check.
+ * @return Whether the snow of the tile has to be updated.
+ */
+static bool ClearAlpsNeedsUpdate(TileIndex tile)
+{
+	int k = GetClearAlpsSnowLevel(tile);
+	if (k < 0) return IsSnowTile(tile);
+	return !IsSnowTile(tile) || GetClearDensity(tile) != std::min<uint>(k, 3u);
+}
+
+/** Convert to or from snowy tiles. */
+static void TileLoopClearAlps(TileIndex tile)
+{
+	int k = GetClearAlpsSnowLevel(tile);
 
 	if (k < 0) {
 		/* Below the snow line, do nothing if no snow. */
@@ -301,6 +322,29 @@ static inline bool NeighbourIsNormal(TileIndex tile)
 	return false;
 }
 
+/**
+ * Get the desert density a tile in the tropic climate should have.
+ * @param tile Tile to get the desert density of.
+ * @return Expected desert density, 0 if it shouldn't be desert.
+ */
+static uint GetClearDesertExpectedDensity(TileIndex tile)
+{
+	if (GetTropicZone(tile) != TROPICZONE_DESERT) return 0;
+	return NeighbourIsNormal(tile) ? 1 : 3;
+}
+
+/**
+ * Check whether TileLoopClearDesert would change a tile.
+ * @param tile Tile to check.
+ * @return Whether the desert of the tile has to be updated.
+ */
+static bool ClearDesertNeedsUpdate(TileIndex tile)
+{
+	uint current = IsClearGround(tile, CLEAR_DESERT) ? GetClearDensity(tile) : 0;
+	if (current == GetClearDesertExpectedDensity(tile)) return false;
+	return !(_allow_rocks_desert && IsClearGround(tile, CLEAR_ROCKS));
+}
+
 static void TileLoopClearDesert(TileIndex tile)
 {
 	/* Current desert level - 0 if it is not desert */
@@ -308,10 +352,7 @@ static void TileLoopClearDesert(TileIndex tile)
 	if (IsClearGround(tile, CLEAR_DESERT)) current = GetClearDensity(tile);
 
 	/* Expected desert level - 0 if it shouldn't be desert */
-	uint expected = 0;
-	if (GetTropicZone(tile) == TROPICZONE_DESERT) {
-		expected = NeighbourIsNormal(tile) ? 1 : 3;
-	}
+	uint expected = GetClearDesertExpectedDensity(tile);
 
 	if (current == expected) return;
 
@@ -382,6 +423,37 @@ static void TileLoop_Clear(TileIndex tile)
 	MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE_NON_VEG);
 }
 
+/**
+ * Run the tile loop of a clear tile, for the common cases which only change the tile itself.
+ * @param tile Tile to process.
+ * @return Whether the tile has been processed, otherwise TileLoop_Clear has to be called for it.
+ */
+static bool TileLoopLocal_Clear(TileIndex tile)
+{
+	if (HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK) || _game_mode == GM_EDITOR) return false;
+
+	/* Snow and desert changes mark the tile dirty */
+	switch (_settings_game.game_creation.landscape) {
+		case LT_TROPIC: if (ClearDesertNeedsUpdate(tile)) return false; break;
+		case LT_ARCTIC: if (ClearAlpsNeedsUpdate(tile)) return false; break;
+	}
+
+	switch (GetClearGround(tile)) {
+		case CLEAR_GRASS:
+			if (GetClearDensity(tile) == 3) return true;
+			if (GetClearCounter(tile) >= 7) return false;
+			AddClearCounter(tile, 1);
+			return true;
+
+		case CLEAR_FIELDS:
+			/* Fences depend on the neighbouring tiles */
+			return false;
+
+		default:
+			return true;
+	}
+}
+
 void GenerateClearTile()
 {
 	uint i, gi;
@@ -475,4 +547,5 @@ extern const TileTypeProcs _tile_type_clear_procs = {
 	nullptr,                     ///< vehicle_enter_tile_proc
 	GetFoundation_Clear,      ///< get_foundation_proc
 	TerraformTile_Clear,      ///< terraform_tile_proc
+	TileLoopLocal_Clear,      ///< tile_loop_local_proc
 };
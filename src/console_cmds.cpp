@@ -61,6 +61,7 @@
 #include "event_logs.h"
 #include "tile_cmd.h"
 #include "object_base.h"
+#include "zone_profiler.h"
 #include <time.h>
 
 #include <set>
@@ -3341,6 +3342,52 @@ DEF_CONSOLE_CMD(ConDeleteCompany)
 	return true;
 }
 
+#ifdef WITH_ZONE_PROFILER
+DEF_CONSOLE_CMD(ConZoneProfile)
+{
+	if (argc != 2) {
+		IConsoleHelp("Record fine-grained game loop zones of all threads. Sub-commands can be abbreviated.");
+		IConsoleHelp("Usage: zone_profile start");
+		IConsoleHelp("  Discard any previously recorded zones and begin recording.");
+		IConsoleHelp("Usage: zone_profile stop");
+		IConsoleHelp("  Stop recording.");
+		IConsoleHelp("Usage: zone_profile export");
+		IConsoleHelp("  Write the most recently recorded zones to a Chrome trace-event JSON file in the screenshot directory.");
+		return true;
+	}
+
+	if (StrStartsWithIgnoreCase(argv[1], "sta")) {
+		StartZoneProfiler();
+		IConsolePrintF(CC_DEBUG, "Started zone profiling");
+		return true;
+	}
+
+	if (StrStartsWithIgnoreCase(argv[1], "sto")) {
+		StopZoneProfiler();
+		IConsolePrintF(CC_DEBUG, "Stopped zone profiling");
+		return true;
+	}
+
+	if (StrStartsWithIgnoreCase(argv[1], "exp")) {
+		char timestamp[16] = {};
+		LocalTime::Format(timestamp, lastof(timestamp), "%Y%m%d-%H%M%S");
+
+		char filepath[MAX_PATH] = {};
+		seprintf(filepath, lastof(filepath), "%szoneprofile-%s.json", FiosGetScreenshotDir(), timestamp);
+
+		uint events;
+		if (ExportZoneProfilerChromeTrace(filepath, &events)) {
+			IConsolePrintF(CC_DEBUG, "Wrote %u zone events to %s", events, filepath);
+		} else {
+			IConsolePrintF(CC_ERROR, "Failed to write %s", filepath);
+		}
+		return true;
+	}
+
+	return false;
+}
+#endif /* WITH_ZONE_PROFILER */
+
 DEF_CONSOLE_CMD(ConNewGRFProfile)
 {
 	if (argc == 0) {
@@ -3868,6 +3915,9 @@ void IConsoleStdLibRegister()
 	/* NewGRF development stuff */
 	IConsole::CmdRegister("reload_newgrfs",          ConNewGRFReload,     ConHookNewGRFDeveloperTool);
 	IConsole::CmdRegister("newgrf_profile",          ConNewGRFProfile,    ConHookNewGRFDeveloperTool);
+#ifdef WITH_ZONE_PROFILER
+	IConsole::CmdRegister("zone_profile",            ConZoneProfile);
+#endif
 	IConsole::CmdRegister("dump_info",               ConDumpInfo);
 	IConsole::CmdRegister("do_disaster",             ConDoDisaster,       ConHookNewGRFDeveloperTool, true);
 	IConsole::CmdRegister("bankrupt_company",        ConBankruptCompany,  ConHookNewGRFDeveloperTool, true);
@@ -115,8 +115,20 @@ DEFINE_POOL_METHOD(inline void *)::AllocateItem(size_t size, size_t index)
 	this->items++;
 
 	Titem *item;
-	if (Tcache && this->alloc_cache != nullptr) {
+	if constexpr (Tcache) {
 		dbg_assert(sizeof(Titem) == size);
+		if (this->alloc_cache == nullptr) {
+			/* Allocate a whole block of items at once, this avoids the per allocation overhead
+			 * and keeps items which are allocated together close to each other in memory. */
+			static_assert(sizeof(Titem) >= sizeof(AllocCache));
+			byte *block = MallocT<byte>(sizeof(Titem) * Tgrowth_step);
+			this->alloc_blocks.push_back(block);
+			for (size_t i = Tgrowth_step; i > 0; i--) {
+				AllocCache *ac = (AllocCache *)(block + (sizeof(Titem) * (i - 1)));
+				ac->next = this->alloc_cache;
+				this->alloc_cache = ac;
+			}
+		}
 		item = (Titem *)this->alloc_cache;
 		this->alloc_cache = this->alloc_cache->next;
 		if (Tzero) {
@@ -124,7 +136,7 @@ DEFINE_POOL_METHOD(inline void *)::AllocateItem(size_t size, size_t index)
 			 * we are actually memsetting a (not-yet-constructed) object */
 			memset((void *)item, 0, sizeof(Titem));
 		}
-	} else if (Tzero) {
+	} else if constexpr (Tzero) {
 		item = (Titem *)CallocT<byte>(size);
 	} else {
 		item = (Titem *)MallocT<byte>(size);
@@ -222,11 +234,13 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	this->cleaning = false;
 
 	if (Tcache) {
-		while (this->alloc_cache != nullptr) {
-			AllocCache *ac = this->alloc_cache;
-			this->alloc_cache = ac->next;
-			free(ac);
+		/* All items are back in the cache now, which only points into the blocks. */
+		for (byte *block : this->alloc_blocks) {
+			free(block);
 		}
+		this->alloc_blocks.clear();
+		this->alloc_blocks.shrink_to_fit();
+		this->alloc_cache = nullptr;
 	}
 }
 
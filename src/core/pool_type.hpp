@@ -73,7 +73,8 @@ private:
  * @tparam Tgrowth_step Size of growths; if the pool is full increase the size by this amount
  * @tparam Tmax_size    Maximum size of the pool
  * @tparam Tpool_type   Type of this pool
- * @tparam Tcache       Whether to perform 'alloc' caching, i.e. don't actually free/malloc just reuse the memory
+ * @tparam Tcache       Whether to perform 'alloc' caching, i.e. don't actually free/malloc just reuse the memory.
+ *                      Cached items are allocated in contiguous blocks of Tgrowth_step items, instead of one by one.
  * @tparam Tzero        Whether to zero the memory
  * @warning when Tcache is enabled *all* instances of this pool's item must be of the same size.
  */
@@ -123,6 +124,15 @@ struct Pool : PoolBase {
 		return index < this->first_unused && this->Get(index) != nullptr;
 	}
 
+	/**
+	 * Get the number of items the memory currently held by this pool can store, including cached free items.
+	 * @return number of item slots allocated
+	 */
+	inline size_t GetAllocatedItemCapacity() const
+	{
+		return Tcache ? this->alloc_blocks.size() * Tgrowth_step : this->items;
+	}
+
 	/**
 	 * Tests whether we can allocate 'n' items
 	 * @param n number of items we want to allocate
@@ -409,6 +419,9 @@ private:
 	/** Cache of freed pointers */
 	AllocCache *alloc_cache;
 
+	/** Blocks of Tgrowth_step items backing all items and the cache, only used when Tcache is enabled */
+	std::vector<byte *> alloc_blocks;
+
 	void *AllocateItem(size_t size, size_t index);
 	void ResizeFor(size_t index);
 	size_t FindFirstFree();
@@ -35,12 +35,32 @@
 #include "departures_type.h"
 #include "tracerestrict.h"
 #include "3rdparty/cpp-btree/btree_set.h"
+#include "3rdparty/cpp-btree/btree_map.h"
 
 #include <map>
 #include <set>
 #include <vector>
 #include <algorithm>
 
+/** Index of the primary vehicles whose orders visit each station, shared by all departure boards. */
+static btree::btree_map<StationID, std::vector<const Vehicle *>> _departure_vehicle_index;
+static bool _departure_vehicle_index_valid = false;
+
+/** A departure or arrival list, which may be shared by several departure boards of the same station with the same filters. */
+struct SharedDepartureList {
+	StationID station;                      ///< The station of the list
+	DepartureType type;                     ///< Whether the list is of departures or arrivals
+	bool show_vehicles_via;                 ///< Whether vehicles passing through the station are included
+	bool show_pax;                          ///< Whether passenger vehicles are included
+	bool show_freight;                      ///< Whether freight vehicles are included
+	std::vector<const Vehicle *> vehicles;  ///< The vehicles the list was made from
+	uint64 tick;                            ///< Value of _scaled_tick_counter when the list was made
+	std::shared_ptr<const DepartureList> list; ///< The list
+};
+
+/** Departure lists made within the last departure calculation period. */
+static std::vector<SharedDepartureList> _shared_departure_lists;
+
 /* A cache of used departure time for scheduled dispatch in departure time calculation */
 typedef std::map<const DispatchSchedule *, btree::btree_set<DateTicksScaled>> schdispatch_cache_t;
 
@@ -874,3 +894,118 @@ DateTicksScaled GetDeparturesMaxTicksAhead()
 		return _settings_client.gui.max_departure_time * DAY_TICKS * _settings_game.economy.day_length_factor;
 	}
 }
+
+/**
+ * Discard the index of vehicles visiting each station.
+ * This should be called whenever vehicles or their order lists are changed.
+ */
+void InvalidateDepartureVehicleIndex()
+{
+	_departure_vehicle_index.clear();
+	_departure_vehicle_index_valid = false;
+}
+
+/**
+ * Discard the departure lists shared between departure boards.
+ * This should be called whenever anything which may affect the lists, such as vehicles, orders or settings, is changed.
+ */
+void InvalidateSharedDepartureLists()
+{
+	_shared_departure_lists.clear();
+}
+
+/**
+ * Discard the index of vehicles visiting each station, and the departure lists shared between departure boards.
+ * This is called when the last departure board is closed.
+ */
+void InvalidateDepartureCaches()
+{
+	InvalidateDepartureVehicleIndex();
+	InvalidateSharedDepartureLists();
+}
+
+/**
+ * Rebuild the index of vehicles visiting each station, with a single pass over all order lists.
+ */
+static void BuildDepartureVehicleIndex()
+{
+	_departure_vehicle_index.clear();
+
+	std::vector<StationID> stations;
+	for (const OrderList *ol : OrderList::Iterate()) {
+		stations.clear();
+		for (const Order *order = ol->GetFirstOrder(); order != nullptr; order = order->next) {
+			if (order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT) || order->IsType(OT_IMPLICIT)) {
+				stations.push_back(order->GetDestination());
+			}
+		}
+		std::sort(stations.begin(), stations.end());
+		stations.erase(std::unique(stations.begin(), stations.end()), stations.end());
+
+		for (StationID station : stations) {
+			std::vector<const Vehicle *> &vehicles = _departure_vehicle_index[station];
+			for (const Vehicle *v = ol->GetFirstSharedVehicle(); v != nullptr; v = v->NextShared()) {
+				vehicles.push_back(v);
+			}
+		}
+	}
+
+	/* Keep the vehicles in pool order, as when iterating over all vehicles */
+	for (auto &it : _departure_vehicle_index) {
+		std::sort(it.second.begin(), it.second.end(), [](const Vehicle *a, const Vehicle *b) {
+			return a->index < b->index;
+		});
+	}
+
+	_departure_vehicle_index_valid = true;
+}
+
+/**
+ * Get the primary vehicles which have an order to visit a station, in vehicle index order.
+ * @param station Station or waypoint ID
+ * @return Vehicles visiting the station
+ */
+const std::vector<const Vehicle *> &GetDepartureVehiclesForStation(StationID station)
+{
+	static const std::vector<const Vehicle *> empty;
+
+	if (!_departure_vehicle_index_valid) BuildDepartureVehicleIndex();
+
+	auto iter = _departure_vehicle_index.find(station);
+	return iter != _departure_vehicle_index.end() ? iter->second : empty;
+}
+
+static void DeleteSharedDepartureList(const DepartureList *list)
+{
+	for (Departure *d : *list) delete d;
+	delete list;
+}
+
+/**
+ * Get a list of departures or arrivals, reusing a list made for another departure board within the current calculation period if possible.
+ * The parameters are the same as for MakeDepartureList.
+ * @param age Set to the number of ticks since the list was made.
+ * @return The list, which must not be modified.
+ */
+std::shared_ptr<const DepartureList> GetSharedDepartureList(StationID station, const std::vector<const Vehicle *> &vehicles, DepartureType type,
+		bool show_vehicles_via, bool show_pax, bool show_freight, uint *age)
+{
+	/* Discard lists which are due to be recalculated */
+	const uint64 max_age = _settings_client.gui.departure_calc_frequency;
+	_shared_departure_lists.erase(std::remove_if(_shared_departure_lists.begin(), _shared_departure_lists.end(), [&](const SharedDepartureList &item) {
+		return _scaled_tick_counter - item.tick >= max_age;
+	}), _shared_departure_lists.end());
+
+	for (const SharedDepartureList &item : _shared_departure_lists) {
+		if (item.station == station && item.type == type && item.show_vehicles_via == show_vehicles_via &&
+				item.show_pax == show_pax && item.show_freight == show_freight && item.vehicles == vehicles) {
+			*age = (uint)(_scaled_tick_counter - item.tick);
+			return item.list;
+		}
+	}
+
+	_shared_departure_lists.push_back({ station, type, show_vehicles_via, show_pax, show_freight, vehicles, _scaled_tick_counter,
+			std::shared_ptr<const DepartureList>(MakeDepartureList(station, vehicles, type, show_vehicles_via, show_pax, show_freight), DeleteSharedDepartureList) });
+	*age = 0;
+	return _shared_departure_lists.back().list;
+}
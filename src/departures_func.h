@@ -16,6 +16,7 @@
 #include "core/smallvec_type.hpp"
 #include "departures_type.h"
 
+#include <memory>
 #include <vector>
 
 DepartureList* MakeDepartureList(StationID station, const std::vector<const Vehicle *> &vehicles, DepartureType type = D_DEPARTURE,
@@ -23,4 +24,11 @@ DepartureList* MakeDepartureList(StationID station, const std::vector<const Vehi
 
 DateTicksScaled GetDeparturesMaxTicksAhead();
 
+void InvalidateDepartureVehicleIndex();
+void InvalidateSharedDepartureLists();
+void InvalidateDepartureCaches();
+const std::vector<const Vehicle *> &GetDepartureVehiclesForStation(StationID station);
+std::shared_ptr<const DepartureList> GetSharedDepartureList(StationID station, const std::vector<const Vehicle *> &vehicles, DepartureType type,
+		bool show_vehicles_via, bool show_pax, bool show_freight, uint *age);
+
 #endif /* DEPARTURES_FUNC_H */
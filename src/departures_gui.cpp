@@ -80,6 +80,7 @@ static uint cached_date_arrow_width = 0;   ///< The cached width of the red/gree
 static uint cached_veh_type_width = 0;     ///< The cached width of the vehicle type icon.
 static bool cached_date_display_method;    ///< Whether the above cached values refers to original (d,m,y) dates or the 24h clock.
 static bool cached_arr_dep_display_method; ///< Whether to show departures and arrivals on a single line.
+static uint _departure_boards_open = 0;     ///< The number of open departure boards.
 
 void FlushDeparturesWindowTextCaches()
 {
@@ -91,8 +92,8 @@ template<bool Twaypoint = false>
 struct DeparturesWindow : public Window {
 protected:
 	StationID station;         ///< The station whose departures we're showing.
-	DepartureList *departures; ///< The current list of departures from this station.
-	DepartureList *arrivals;   ///< The current list of arrivals from this station.
+	std::shared_ptr<const DepartureList> departures; ///< The current list of departures from this station.
+	std::shared_ptr<const DepartureList> arrivals;   ///< The current list of arrivals from this station.
 	bool departures_invalid;   ///< The departures and arrivals list are currently invalid.
 	bool vehicles_invalid;     ///< The vehicles list is currently invalid.
 	uint entry_height;         ///< The height of an entry in the departures list.
@@ -115,7 +116,6 @@ protected:
 	virtual uint GetMinWidth() const;
 	static void RecomputeDateWidth();
 	virtual void DrawDeparturesListItems(const Rect &r) const;
-	void DeleteDeparturesList(DepartureList* list);
 
 	void ToggleCargoFilter(int widget, bool &flag)
 	{
@@ -165,34 +165,28 @@ protected:
 		CompanyMask companies = 0;
 		int unitnumber_max[4] = { -1, -1, -1, -1 };
 
-		for (const Vehicle *v : Vehicle::Iterate()) {
-			if (v->type < 4 && this->show_types[v->type] && v->IsPrimaryVehicle()) {
-				for(const Order *order : v->Orders()) {
-					if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT) || order->IsType(OT_IMPLICIT))
-							&& order->GetDestination() == this->station) {
-						this->vehicles.push_back(v);
-
-						if (_settings_client.gui.departure_show_vehicle) {
-							if (v->name.empty() && !(v->group_id != DEFAULT_GROUP && _settings_client.gui.vehicle_names != 0)) {
-								if (v->unitnumber > unitnumber_max[v->type]) unitnumber_max[v->type] = v->unitnumber;
-							} else {
-								SetDParam(0, v->index | (_settings_client.gui.departure_show_group ? VEHICLE_NAME_NO_GROUP : 0));
-								int width = (GetStringBoundingBox(STR_DEPARTURES_VEH)).width + 4;
-								if (width > this->veh_width) this->veh_width = width;
-							}
-						}
+		for (const Vehicle *v : GetDepartureVehiclesForStation(this->station)) {
+			if (v->type >= 4 || !this->show_types[v->type]) continue;
 
-						if (v->group_id != INVALID_GROUP && v->group_id != DEFAULT_GROUP && _settings_client.gui.departure_show_group) {
-							groups.insert(v->group_id);
-						}
+			this->vehicles.push_back(v);
 
-						if (_settings_client.gui.departure_show_company) {
-							SetBit(companies, v->owner);
-						}
-						break;
-					}
+			if (_settings_client.gui.departure_show_vehicle) {
+				if (v->name.empty() && !(v->group_id != DEFAULT_GROUP && _settings_client.gui.vehicle_names != 0)) {
+					if (v->unitnumber > unitnumber_max[v->type]) unitnumber_max[v->type] = v->unitnumber;
+				} else {
+					SetDParam(0, v->index | (_settings_client.gui.departure_show_group ? VEHICLE_NAME_NO_GROUP : 0));
+					int width = (GetStringBoundingBox(STR_DEPARTURES_VEH)).width + 4;
+					if (width > this->veh_width) this->veh_width = width;
 				}
 			}
+
+			if (v->group_id != INVALID_GROUP && v->group_id != DEFAULT_GROUP && _settings_client.gui.departure_show_group) {
+				groups.insert(v->group_id);
+			}
+
+			if (_settings_client.gui.departure_show_company) {
+				SetBit(companies, v->owner);
+			}
 		}
 
 		for (uint i = 0; i < 4; i++) {
@@ -235,8 +229,8 @@ public:
 
 	DeparturesWindow(WindowDesc *desc, WindowNumber window_number) : Window(desc),
 		station(window_number),
-		departures(new DepartureList()),
-		arrivals(new DepartureList()),
+		departures(std::make_shared<const DepartureList>()),
+		arrivals(std::make_shared<const DepartureList>()),
 		departures_invalid(true),
 		vehicles_invalid(true),
 		elapsed_ms(0),
@@ -283,6 +277,7 @@ public:
 			this->LowerWidget(WID_DB_SHOW_VIA);
 		}
 
+		_departure_boards_open++;
 		this->RefreshVehicleList();
 
 		if (_pause_mode != PM_UNPAUSED) this->OnGameTick();
@@ -290,8 +285,8 @@ public:
 
 	virtual ~DeparturesWindow()
 	{
-		this->DeleteDeparturesList(departures);
-		this->DeleteDeparturesList(this->arrivals);
+		/* The shared caches are not kept up to date while no departure boards are open. */
+		if (--_departure_boards_open == 0) InvalidateDepartureCaches();
 	}
 
 	void SetupValues()
@@ -491,13 +486,14 @@ public:
 
 		/* Recompute the list of departures if we're due to. */
 		if (this->calc_tick_countdown <= 0) {
-			this->calc_tick_countdown = _settings_client.gui.departure_calc_frequency;
-			this->DeleteDeparturesList(this->departures);
-			this->DeleteDeparturesList(this->arrivals);
 			bool show_pax = _settings_client.gui.departure_only_passengers ? true : this->show_pax;
 			bool show_freight = _settings_client.gui.departure_only_passengers ? false : this->show_freight;
-			this->departures = (this->departure_types[0] || _settings_client.gui.departure_show_both ? MakeDepartureList(this->station, this->vehicles, D_DEPARTURE, Twaypoint || this->departure_types[2], show_pax, show_freight) : new DepartureList());
-			this->arrivals   = (this->departure_types[1] && !_settings_client.gui.departure_show_both ? MakeDepartureList(this->station, this->vehicles, D_ARRIVAL, false, show_pax, show_freight) : new DepartureList());
+			uint departures_age = 0;
+			uint arrivals_age = 0;
+			this->departures = (this->departure_types[0] || _settings_client.gui.departure_show_both ? GetSharedDepartureList(this->station, this->vehicles, D_DEPARTURE, Twaypoint || this->departure_types[2], show_pax, show_freight, &departures_age) : std::make_shared<const DepartureList>());
+			this->arrivals   = (this->departure_types[1] && !_settings_client.gui.departure_show_both ? GetSharedDepartureList(this->station, this->vehicles, D_ARRIVAL, false, show_pax, show_freight, &arrivals_age) : std::make_shared<const DepartureList>());
+			/* Recompute when the oldest shared list is due to be recalculated, so that boards sharing lists refresh together */
+			this->calc_tick_countdown = _settings_client.gui.departure_calc_frequency - std::max(departures_age, arrivals_age);
 			this->departures_invalid = false;
 			this->SetWidgetDirty(WID_DB_LIST);
 		}
@@ -557,6 +553,8 @@ public:
 	 */
 	void OnInvalidateData(int data = 0, bool gui_scope = true) override
 	{
+		InvalidateSharedDepartureLists();
+		if (data == 0) InvalidateDepartureVehicleIndex();
 		this->vehicles_invalid = true;
 		this->departures_invalid = true;
 		if (data > 0) {
@@ -638,23 +636,6 @@ uint DeparturesWindow<Twaypoint>::GetMinWidth() const
 	return result + ScaleGUITrad(140);
 }
 
-/**
- * Deletes this window's departure list.
- */
-template<bool Twaypoint>
-void DeparturesWindow<Twaypoint>::DeleteDeparturesList(DepartureList *list)
-{
-	/* SmallVector uses free rather than delete on its contents (which doesn't invoke the destructor), so we need to delete each departure manually. */
-	for (uint i = 0; i < list->size(); ++i) {
-		Departure **d = &(*list)[i];
-		delete *d;
-		/* Make sure a double free doesn't happen. */
-		*d = nullptr;
-	}
-	delete list;
-	list = nullptr;
-}
-
 /**
  * Draws a list of departures.
  */
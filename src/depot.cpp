@@ -16,6 +16,13 @@
 #include "vehicle_gui.h"
 #include "vehiclelist.h"
 #include "tracerestrict.h"
+#include "depot_func.h"
+#include "infrastructure_func.h"
+#include "map_func.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
 
 #include "safeguards.h"
 
@@ -23,11 +30,18 @@
 DepotPool _depot_pool("Depot");
 INSTANTIATE_POOL_METHODS(Depot)
 
+Depot::Depot(TileIndex xy) : xy(xy)
+{
+	InvalidateDepotSpatialIndex();
+}
+
 /**
  * Clean up a depot
  */
 Depot::~Depot()
 {
+	InvalidateDepotSpatialIndex();
+
 	if (CleaningPool()) return;
 
 	if (!IsDepotTile(this->xy) || GetDepotIndex(this->xy) != this->index) {
@@ -50,3 +64,98 @@ Depot::~Depot()
 	VehicleType vt = GetDepotVehicleType(this->xy);
 	DeleteWindowById(GetWindowClassForVehicleType(vt), VehicleListIdentifier(VL_DEPOT_LIST, vt, GetTileOwner(this->xy), this->index).Pack());
 }
+
+static const uint DEPOT_INDEX_CELL_LOG = 5; ///< Log2 of the edge length of a cell of the depot spatial index, in tiles
+
+/** Depot in the depot spatial index */
+struct DepotIndexEntry {
+	uint32 cell;   ///< Cell of the depot
+	DepotID id;    ///< Depot ID
+	TileIndex xy;  ///< Depot tile
+
+	bool operator<(const DepotIndexEntry &other) const
+	{
+		return std::tie(this->cell, this->id) < std::tie(other.cell, other.id);
+	}
+};
+
+/**
+ * Depots of each vehicle type, sorted by the cell they are in and then by ID.
+ * This is only a function of the depot pool and depot tiles, so it is rebuilt lazily when depots are added or removed.
+ */
+static std::vector<DepotIndexEntry> _depot_spatial_index[VEH_SHIP + 1];
+static uint _depot_spatial_index_cells_x;
+static bool _depot_spatial_index_valid = false;
+
+/** Mark the depot spatial index as needing to be rebuilt. */
+void InvalidateDepotSpatialIndex()
+{
+	_depot_spatial_index_valid = false;
+}
+
+static void RebuildDepotSpatialIndex()
+{
+	for (auto &entries : _depot_spatial_index) entries.clear();
+	_depot_spatial_index_cells_x = (MapSizeX() >> DEPOT_INDEX_CELL_LOG) + 1;
+
+	for (const Depot *depot : Depot::Iterate()) {
+		if (!IsDepotTile(depot->xy)) continue;
+		VehicleType type = GetDepotVehicleType(depot->xy);
+		if (type > VEH_SHIP) continue;
+		uint32 cell = (TileY(depot->xy) >> DEPOT_INDEX_CELL_LOG) * _depot_spatial_index_cells_x + (TileX(depot->xy) >> DEPOT_INDEX_CELL_LOG);
+		_depot_spatial_index[type].push_back({ cell, depot->index, depot->xy });
+	}
+	for (auto &entries : _depot_spatial_index) std::sort(entries.begin(), entries.end());
+
+	_depot_spatial_index_valid = true;
+}
+
+/**
+ * Find the nearest depot by Manhattan distance, which a vehicle may use.
+ * Ties are broken by lowest depot ID, which matches a linear search of the depot pool.
+ * This does not check whether the depot is reachable, it is intended to rule out pathfinder searches which cannot succeed.
+ * @param type Vehicle type, rail, road or ship.
+ * @param owner Owner of the vehicle.
+ * @param tile Tile to measure the distance from.
+ * @param max_distance Maximum Manhattan distance of the depot, or 0 for no maximum.
+ * @return The nearest depot, or nullptr if there is none within max_distance.
+ */
+const Depot *FindNearestDepotWithinManhattanDistance(VehicleType type, Owner owner, TileIndex tile, uint max_distance)
+{
+	assert(type <= VEH_SHIP);
+	if (!_depot_spatial_index_valid) RebuildDepotSpatialIndex();
+
+	const std::vector<DepotIndexEntry> &entries = _depot_spatial_index[type];
+
+	const DepotIndexEntry *best = nullptr;
+	uint best_dist = max_distance == 0 ? UINT_MAX : max_distance + 1;
+
+	auto check_entry = [&](const DepotIndexEntry &entry) {
+		uint dist = DistanceManhattan(entry.xy, tile);
+		if (dist > best_dist || (dist == best_dist && (best == nullptr || entry.id > best->id))) return;
+		if (!IsInfraTileUsageAllowed(type, owner, entry.xy)) return;
+		best = &entry;
+		best_dist = dist;
+	};
+
+	if (max_distance == 0 || max_distance >= MapMaxX() + MapMaxY()) {
+		for (const DepotIndexEntry &entry : entries) check_entry(entry);
+	} else {
+		const uint x = TileX(tile);
+		const uint y = TileY(tile);
+		const uint cx0 = (x - std::min(x, max_distance)) >> DEPOT_INDEX_CELL_LOG;
+		const uint cx1 = std::min(x + max_distance, MapMaxX()) >> DEPOT_INDEX_CELL_LOG;
+		const uint cy0 = (y - std::min(y, max_distance)) >> DEPOT_INDEX_CELL_LOG;
+		const uint cy1 = std::min(y + max_distance, MapMaxY()) >> DEPOT_INDEX_CELL_LOG;
+		for (uint cy = cy0; cy <= cy1; cy++) {
+			const uint32 first_cell = cy * _depot_spatial_index_cells_x + cx0;
+			const uint32 last_cell = cy * _depot_spatial_index_cells_x + cx1;
+			auto iter = std::lower_bound(entries.begin(), entries.end(), first_cell, [](const DepotIndexEntry &entry, uint32 cell) {
+				return entry.cell < cell;
+			});
+			for (; iter != entries.end() && iter->cell <= last_cell; ++iter) check_entry(*iter);
+		}
+	}
+
+	return best != nullptr ? Depot::Get(best->id) : nullptr;
+}
@@ -12,12 +12,17 @@
 
 #include "vehicle_type.h"
 #include "slope_func.h"
+#include "company_type.h"
+#include "depot_type.h"
 
 void ShowDepotWindow(TileIndex tile, VehicleType type);
 void InitDepotWindowBlockSizes();
 
 void DeleteDepotHighlightOfVehicle(const Vehicle *v);
 
+void InvalidateDepotSpatialIndex();
+const Depot *FindNearestDepotWithinManhattanDistance(VehicleType type, Owner owner, TileIndex tile, uint max_distance);
+
 /**
  * Find out if the slope of the tile is suitable to build a depot of given direction
  * @param direction The direction in which the depot's exit points
@@ -57,6 +57,8 @@
 #include "pathfinder/yapf/yapf_cache.h"
 #include "debug_desync.h"
 #include "event_logs.h"
+#include "zone_profiler.h"
+#include "3rdparty/cpp-btree/btree_set.h"
 
 #include "table/strings.h"
 #include "table/pricebase.h"
@@ -1487,6 +1489,7 @@ void PrepareUnload(Vehicle *front_v)
 {
 	Station *curr_station = Station::Get(front_v->last_station_visited);
 	curr_station->loading_vehicles.push_back(front_v);
+	_tick_loading_station_cache.insert(curr_station->index);
 
 	/* At this moment loading cannot be finished */
 	ClrBit(front_v->vehicle_flags, VF_LOADING_FINISHED);
@@ -2359,6 +2362,8 @@ void LoadUnloadStation(Station *st)
 	/* No vehicle is here... */
 	if (st->loading_vehicles.empty()) return;
 
+	ZONE_PROFILE("LoadUnloadStation");
+
 	Vehicle *last_loading = nullptr;
 
 	/* Check if anything will be loaded at all. Otherwise we don't need to reserve either. */
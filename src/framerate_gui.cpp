@@ -23,6 +23,7 @@
 #include "ai/ai_instance.hpp"
 #include "game/game.hpp"
 #include "game/game_instance.hpp"
+#include "date_func.h"
 
 #include "widgets/framerate_widget.h"
 
@@ -49,6 +50,9 @@ namespace {
 	/** %Units a second is divided into in performance measurements */
 	const TimingMeasurement TIMESTAMP_PRECISION = 1000000;
 
+	/** Whether every measurement is currently also being recorded for #WritePerformanceRecordingJSON */
+	bool _pf_recording = false;
+
 	struct PerformanceData {
 		/** Duration value indicating the value is not valid should be considered a gap in measurements */
 		static const TimingMeasurement INVALID_DURATION = UINT64_MAX;
@@ -71,6 +75,9 @@ namespace {
 		/** Start time for current accumulation cycle */
 		TimingMeasurement acc_timestamp;
 
+		/** All durations measured since recording started, see #StartPerformanceRecording */
+		std::vector<TimingMeasurement> recorded;
+
 		/**
 		 * Initialize a data element with an expected collection rate
 		 * @param expected_rate
@@ -84,6 +91,7 @@ namespace {
 		{
 			this->durations[this->next_index] = end_time - start_time;
 			this->timestamps[this->next_index] = start_time;
+			if (_pf_recording) this->recorded.push_back(end_time - start_time);
 			this->prev_index = this->next_index;
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
@@ -95,6 +103,7 @@ namespace {
 		{
 			this->timestamps[this->next_index] = this->acc_timestamp;
 			this->durations[this->next_index] = this->acc_duration;
+			if (_pf_recording) this->recorded.push_back(this->acc_duration);
 			this->prev_index = this->next_index;
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
@@ -147,6 +156,25 @@ namespace {
 			return sumtime * 1000 / count / TIMESTAMP_PRECISION;
 		}
 
+		/** Summarise the most recent data points, skipping invalid points */
+		PerformanceSummary GetSummary(int count)
+		{
+			count = std::min(count, this->num_valid);
+
+			int first_point = this->prev_index - count;
+			if (first_point < 0) first_point += NUM_FRAMERATE_POINTS;
+
+			PerformanceSummary summary = { 0, 0, 0 };
+			for (int i = first_point; i < first_point + count; i++) {
+				auto d = this->durations[i % NUM_FRAMERATE_POINTS];
+				if (d == INVALID_DURATION) continue;
+				summary.samples++;
+				summary.total += d;
+				summary.peak = std::max(summary.peak, d);
+			}
+			return summary;
+		}
+
 		/** Get current rate of a performance element, based on approximately the past one second of data */
 		double GetRate()
 		{
@@ -324,6 +352,20 @@ void PerformanceAccumulator::Reset(PerformanceElement elem)
 }
 
 
+/**
+ * Summarise the most recent measurements of a performance element, without any formatting or averaging.
+ * This is cheap enough to be called periodically by non-GUI consumers, such as the admin network.
+ * @param elem The element to summarise
+ * @param count Maximum number of most recent data points to include
+ * @return Number, sum and maximum of the included durations, in microseconds
+ */
+PerformanceSummary GetPerformanceSummary(PerformanceElement elem, int count)
+{
+	assert(elem < PFE_MAX);
+	return _pf_data[elem].GetSummary(count);
+}
+
+
 void ShowFrametimeGraphWindow(PerformanceElement elem);
 
 
@@ -388,7 +430,10 @@ static const NWidgetPart _framerate_window_widgets[] = {
 					NWidget(WWT_EMPTY, COLOUR_GREY, WID_FRW_TIMES_CURRENT), SetScrollbar(WID_FRW_SCROLLBAR),
 					NWidget(WWT_EMPTY, COLOUR_GREY, WID_FRW_TIMES_AVERAGE), SetScrollbar(WID_FRW_SCROLLBAR),
 					NWidget(NWID_SELECTION, INVALID_COLOUR, WID_FRW_SEL_MEMORY),
-						NWidget(WWT_EMPTY, COLOUR_GREY, WID_FRW_ALLOCSIZE), SetScrollbar(WID_FRW_SCROLLBAR),
+						NWidget(NWID_HORIZONTAL), SetPIP(0, WidgetDimensions::unscaled.hsep_wide, 0),
+							NWidget(WWT_EMPTY, COLOUR_GREY, WID_FRW_ALLOCSIZE), SetScrollbar(WID_FRW_SCROLLBAR),
+							NWidget(WWT_EMPTY, COLOUR_GREY, WID_FRW_GC_PAUSES), SetScrollbar(WID_FRW_SCROLLBAR),
+						EndContainer(),
 					EndContainer(),
 				EndContainer(),
 				NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_INFO_DATA_POINTS), SetDataTip(STR_FRAMERATE_DATA_POINTS, 0x0), SetFill(1, 0), SetResize(1, 0),
@@ -592,6 +637,17 @@ struct FramerateWindow : Window {
 				resize->height = FONT_HEIGHT_NORMAL;
 				break;
 			}
+
+			case WID_FRW_GC_PAUSES: {
+				*size = GetStringBoundingBox(STR_FRAMERATE_GC_PAUSES);
+				for (uint i = 0; i < ScriptInstance::GC_PAUSE_HISTOGRAM_BUCKETS; i++) SetDParam(i, 9999);
+				Dimension item_size = GetStringBoundingBox(STR_FRAMERATE_GC_PAUSE_COUNTS);
+				size->width = std::max(size->width, item_size.width);
+				size->height += FONT_HEIGHT_NORMAL * MIN_ELEMENTS + WidgetDimensions::scaled.vsep_normal;
+				resize->width = 0;
+				resize->height = FONT_HEIGHT_NORMAL;
+				break;
+			}
 		}
 	}
 
@@ -649,6 +705,34 @@ struct FramerateWindow : Window {
 		}
 	}
 
+	/** Render a column of garbage collection pause histograms of scripts */
+	void DrawElementGCPausesColumn(const Rect &r) const
+	{
+		const Scrollbar *sb = this->GetScrollbar(WID_FRW_SCROLLBAR);
+		uint16 skip = sb->GetPosition();
+		int drawable = this->num_displayed;
+		int y = r.top;
+		DrawString(r.left, r.right, y, STR_FRAMERATE_GC_PAUSES, TC_FROMSTRING, SA_CENTER, true);
+		y += FONT_HEIGHT_NORMAL + WidgetDimensions::scaled.vsep_normal;
+		for (PerformanceElement e : DISPLAY_ORDER_PFE) {
+			if (_pf_data[e].num_valid == 0) continue;
+			if (skip > 0) {
+				skip--;
+				continue;
+			}
+			if (e == PFE_GAMESCRIPT || e >= PFE_AI0) {
+				const ScriptInstance *instance = (e == PFE_GAMESCRIPT) ? static_cast<const ScriptInstance *>(Game::GetInstance()) : Company::Get(e - PFE_AI0)->ai_instance;
+				const ScriptInstance::GCPauseHistogram &histogram = instance->GetGCPauseHistogram();
+				for (uint i = 0; i < ScriptInstance::GC_PAUSE_HISTOGRAM_BUCKETS; i++) SetDParam(i, histogram[i]);
+				DrawString(r.left, r.right, y, STR_FRAMERATE_GC_PAUSE_COUNTS, TC_FROMSTRING, SA_RIGHT);
+			}
+			/* Leave lines of non-script elements empty */
+			y += FONT_HEIGHT_NORMAL;
+			drawable--;
+			if (drawable == 0) break;
+		}
+	}
+
 	void DrawWidget(const Rect &r, int widget) const override
 	{
 		switch (widget) {
@@ -688,6 +772,9 @@ struct FramerateWindow : Window {
 			case WID_FRW_ALLOCSIZE:
 				DrawElementAllocationsColumn(r);
 				break;
+			case WID_FRW_GC_PAUSES:
+				DrawElementGCPausesColumn(r);
+				break;
 		}
 	}
 
@@ -1107,3 +1194,91 @@ void ProcessPendingPerformanceMeasurements()
 		_sound_perf_pending.store(false, std::memory_order_relaxed);
 	}
 }
+
+static TimingMeasurement _pf_recording_start_time; ///< Performance timer value when recording started
+static uint64 _pf_recording_start_tick;            ///< _tick_counter when recording started
+
+/**
+ * Start recording every measurement of every performance element, for an unlimited number of data points.
+ * Used by the benchmark mode of the null video driver.
+ */
+void StartPerformanceRecording()
+{
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		_pf_data[e].recorded.clear();
+	}
+	_pf_recording = true;
+	_pf_recording_start_time = GetPerformanceTimer();
+	_pf_recording_start_tick = _tick_counter;
+}
+
+/**
+ * Stop recording and write the total tick rate and the distribution of the durations
+ * of each performance element seen since #StartPerformanceRecording as JSON.
+ * @param f File to write to.
+ */
+void WritePerformanceRecordingJSON(FILE *f)
+{
+	const TimingMeasurement elapsed = GetPerformanceTimer() - _pf_recording_start_time;
+	const uint64 ticks = _tick_counter - _pf_recording_start_tick;
+	_pf_recording = false;
+
+	static const char *ELEMENT_NAMES[PFE_AI0] = {
+		"gameloop",
+		"gl_economy",
+		"gl_trains",
+		"gl_roadvehs",
+		"gl_ships",
+		"gl_aircraft",
+		"gl_landscape",
+		"gl_linkgraph",
+		"drawing",
+		"drawworld",
+		"video",
+		"sound",
+		"allscripts",
+		"gamescript",
+	};
+
+	const double seconds = (double)elapsed / TIMESTAMP_PRECISION;
+	fprintf(f, "{\n");
+	fprintf(f, "  \"ticks\": " OTTD_PRINTF64U ",\n", ticks);
+	fprintf(f, "  \"seconds\": %.6f,\n", seconds);
+	fprintf(f, "  \"ticks_per_second\": %.3f,\n", seconds > 0 ? ticks / seconds : 0.0);
+	fprintf(f, "  \"elements\": {");
+
+	bool first = true;
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		std::vector<TimingMeasurement> &durations = _pf_data[e].recorded;
+		if (durations.empty()) continue;
+		std::sort(durations.begin(), durations.end());
+
+		TimingMeasurement total = 0;
+		for (TimingMeasurement d : durations) total += d;
+
+		/* Nearest-rank percentile, in milliseconds */
+		auto percentile = [&](uint p) -> double {
+			size_t rank = (durations.size() * p + 99) / 100;
+			return (double)durations[std::max<size_t>(rank, 1) - 1] * 1000 / TIMESTAMP_PRECISION;
+		};
+
+		char ai_name_buf[16];
+		const char *name = ELEMENT_NAMES[std::min<uint>(e, PFE_AI0 - 1)];
+		if (e >= PFE_AI0) {
+			seprintf(ai_name_buf, lastof(ai_name_buf), "ai%d", e - PFE_AI0);
+			name = ai_name_buf;
+		}
+
+		fprintf(f, "%s\n    \"%s\": { \"samples\": " PRINTF_SIZE ", \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p90_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }",
+				first ? "" : ",", name, durations.size(),
+				(double)total * 1000 / TIMESTAMP_PRECISION / durations.size(),
+				percentile(50), percentile(90), percentile(99), percentile(100));
+		first = false;
+
+		durations.clear();
+		durations.shrink_to_fit();
+	}
+
+	fprintf(f, "\n  }\n}\n");
+	fflush(f);
+}
@@ -120,6 +120,18 @@ public:
 	static void Reset(PerformanceElement elem);
 };
 
+/** Summary of recent measurements of a performance element, see #GetPerformanceSummary */
+struct PerformanceSummary {
+	uint samples;            ///< Number of valid data points summarised
+	TimingMeasurement total; ///< Sum of the summarised durations, in microseconds
+	TimingMeasurement peak;  ///< Longest single summarised duration, in microseconds
+};
+
+PerformanceSummary GetPerformanceSummary(PerformanceElement elem, int count);
+
+void StartPerformanceRecording();
+void WritePerformanceRecordingJSON(FILE *f);
+
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
 
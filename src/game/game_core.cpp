@@ -48,10 +48,7 @@
 	Game::instance->GameLoop();
 	cur_company.Restore();
 
-	/* Occasionally collect garbage */
-	if ((Game::frame_counter & 255) == 0) {
-		Game::instance->CollectGarbage();
-	}
+	Game::instance->CollectGarbageIfDue();
 }
 
 /* static */ void Game::Initialize()
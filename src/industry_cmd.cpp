@@ -11,6 +11,7 @@
 #include "clear_map.h"
 #include "industry.h"
 #include "station_base.h"
+#include "station_func.h"
 #include "landscape.h"
 #include "viewport_func.h"
 #include "command_func.h"
@@ -24,6 +25,7 @@
 #include "newgrf_cargo.h"
 #include "newgrf_debug.h"
 #include "newgrf_industrytiles.h"
+#include "newgrf_house.h"
 #include "autoslope.h"
 #include "water.h"
 #include "strings_func.h"
@@ -146,6 +148,8 @@ Industry::~Industry()
 
 	const bool has_neutral_station = this->neutral_station != nullptr;
 
+	InvalidateStationCatchmentAcceptance(this->location);
+
 	for (TileIndex tile_cur : this->location) {
 		if (IsTileType(tile_cur, MP_INDUSTRY)) {
 			if (GetIndustryIndex(tile_cur) == this->index) {
@@ -552,6 +556,28 @@ static bool TransportIndustryGoods(TileIndex tile)
 	return moved_cargo;
 }
 
+/**
+ * Change the graphics of an industry tile, and invalidate the catchment acceptance of nearby stations if the acceptance of the new graphics may differ.
+ * @param tile the industry tile
+ * @param gfx the new graphics
+ */
+static void ChangeIndustryTileGfx(TileIndex tile, IndustryGfx gfx)
+{
+	const IndustryTileSpec *old_spec = GetIndustryTileSpec(GetIndustryGfx(tile));
+	const IndustryTileSpec *new_spec = GetIndustryTileSpec(gfx);
+	SetIndustryGfx(tile, gfx);
+	if (old_spec == new_spec) return;
+
+	const uint8 acceptance_callbacks = (1 << CBM_INDT_CARGO_ACCEPTANCE) | (1 << CBM_INDT_ACCEPT_CARGO);
+	if (memcmp(old_spec->accepts_cargo, new_spec->accepts_cargo, sizeof(old_spec->accepts_cargo)) == 0 &&
+			memcmp(old_spec->acceptance, new_spec->acceptance, sizeof(old_spec->acceptance)) == 0 &&
+			((old_spec->special_flags ^ new_spec->special_flags) & INDTILE_SPECIAL_ACCEPTS_ALL_CARGO) == 0 &&
+			((old_spec->callback_mask | new_spec->callback_mask) & acceptance_callbacks) == 0) {
+		return;
+	}
+	InvalidateStationCatchmentAcceptance(TileArea(tile, 1, 1));
+}
+
 static void AnimateSugarSieve(TileIndex tile)
 {
 	byte m = GetAnimationFrame(tile) + 1;
@@ -641,7 +667,7 @@ static void AnimateToyFactory(TileIndex tile)
 static void AnimatePlasticFountain(TileIndex tile, IndustryGfx gfx)
 {
 	gfx = (gfx < GFX_PLASTIC_FOUNTAIN_ANIMATED_8) ? gfx + 1 : GFX_PLASTIC_FOUNTAIN_ANIMATED_1;
-	SetIndustryGfx(tile, gfx);
+	ChangeIndustryTileGfx(tile, gfx);
 	MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 }
 
@@ -650,12 +676,12 @@ static void AnimateOilWell(TileIndex tile, IndustryGfx gfx)
 	bool b = Chance16(1, 7);
 	byte m = GetAnimationFrame(tile) + 1;
 	if (m == 4 && (m = 0, ++gfx) == GFX_OILWELL_ANIMATED_3 + 1 && (gfx = GFX_OILWELL_ANIMATED_1, b)) {
-		SetIndustryGfx(tile, GFX_OILWELL_NOT_ANIMATED);
+		ChangeIndustryTileGfx(tile, GFX_OILWELL_NOT_ANIMATED);
 		SetIndustryConstructionStage(tile, 3);
 		DeleteAnimatedTile(tile);
 	} else {
 		SetAnimationFrame(tile, m);
-		SetIndustryGfx(tile, gfx);
+		ChangeIndustryTileGfx(tile, gfx);
 		MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 	}
 }
@@ -900,7 +926,7 @@ static void TileLoop_Industry(TileIndex tile)
 		if (newgfx != INDUSTRYTILE_NOANIM) {
 			ResetIndustryConstructionStage(tile);
 			SetIndustryCompleted(tile);
-			SetIndustryGfx(tile, newgfx);
+			ChangeIndustryTileGfx(tile, newgfx);
 			MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 			return;
 		}
@@ -911,7 +937,7 @@ static void TileLoop_Industry(TileIndex tile)
 	IndustryGfx newgfx = GetIndustryTileSpec(GetIndustryGfx(tile))->anim_next;
 	if (newgfx != INDUSTRYTILE_NOANIM) {
 		ResetIndustryConstructionStage(tile);
-		SetIndustryGfx(tile, newgfx);
+		ChangeIndustryTileGfx(tile, newgfx);
 		MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 		return;
 	}
@@ -927,7 +953,7 @@ static void TileLoop_Industry(TileIndex tile)
 				case GFX_COPPER_MINE_TOWER_NOT_ANIMATED: gfx = GFX_COPPER_MINE_TOWER_ANIMATED; break;
 				case GFX_GOLD_MINE_TOWER_NOT_ANIMATED:   gfx = GFX_GOLD_MINE_TOWER_ANIMATED;   break;
 			}
-			SetIndustryGfx(tile, gfx);
+			ChangeIndustryTileGfx(tile, gfx);
 			SetAnimationFrame(tile, 0x80);
 			AddAnimatedTile(tile);
 		}
@@ -935,7 +961,7 @@ static void TileLoop_Industry(TileIndex tile)
 
 	case GFX_OILWELL_NOT_ANIMATED:
 		if (Chance16(1, 6)) {
-			SetIndustryGfx(tile, GFX_OILWELL_ANIMATED_1);
+			ChangeIndustryTileGfx(tile, GFX_OILWELL_ANIMATED_1);
 			SetAnimationFrame(tile, 0);
 			AddAnimatedTile(tile);
 		}
@@ -950,7 +976,7 @@ static void TileLoop_Industry(TileIndex tile)
 				case GFX_COPPER_MINE_TOWER_ANIMATED: gfx = GFX_COPPER_MINE_TOWER_NOT_ANIMATED; break;
 				case GFX_GOLD_MINE_TOWER_ANIMATED:   gfx = GFX_GOLD_MINE_TOWER_NOT_ANIMATED;   break;
 			}
-			SetIndustryGfx(tile, gfx);
+			ChangeIndustryTileGfx(tile, gfx);
 			SetIndustryCompleted(tile);
 			SetIndustryConstructionStage(tile, 3);
 			DeleteAnimatedTile(tile);
@@ -2021,7 +2047,10 @@ static void DoCreateNewIndustry(Industry *i, TileIndex tile, IndustryType type,
 	InvalidateWindowData(WC_INDUSTRY_DIRECTORY, 0, IDIWD_FORCE_REBUILD);
 	SetWindowDirty(WC_BUILD_INDUSTRY, 0);
 
-	if (!_generating_world) PopulateStationsNearby(i);
+	if (!_generating_world) {
+		PopulateStationsNearby(i);
+		InvalidateStationCatchmentAcceptance(i->location);
+	}
 	if (_game_mode == GM_NORMAL) RegisterGameEvents(GEF_INDUSTRY_CREATE);
 }
 
@@ -2390,9 +2419,13 @@ static Industry *PlaceIndustry(IndustryType type, IndustryAvailabilityCallType c
 	for (; tries > 0; tries--) {
 		TileIndex tile = RandomTile();
 		TileIndex temp = tile;
-		Industry *ind;
-		/* Only place an industry if it is somewhat near a house tile. */
-		if (CircularTileSearch(&temp, 200, FindNearestHouse, nullptr)) {
+		Industry *ind = nullptr;
+		/* Only place an industry if it is somewhat near a house tile.
+		 * Most tiles far away from any house are ruled out using the house tile block counts,
+		 * the area checked covers the whole area searched by CircularTileSearch. */
+		const int x = TileX(tile);
+		const int y = TileY(tile);
+		if (MayHaveHouseTilesInArea(x - 99, y - 99, x + 100, y + 100) && CircularTileSearch(&temp, 200, FindNearestHouse, nullptr)) {
 			ind = CreateNewIndustry(tile, type, creation_type);
 		}
 		if (ind != nullptr) return ind;
@@ -3242,6 +3275,7 @@ extern const TileTypeProcs _tile_type_industry_procs = {
 	nullptr,                        // vehicle_enter_tile_proc
 	GetFoundation_Industry,      // get_foundation_proc
 	TerraformTile_Industry,      // terraform_tile_proc
+	nullptr,                     // tile_loop_local_proc
 };
 
 bool IndustryCompare::operator() (const IndustryListEntry &lhs, const IndustryListEntry &rhs) const
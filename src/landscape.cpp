@@ -35,6 +35,8 @@
 #include "town.h"
 #include "3rdparty/cpp-btree/btree_set.h"
 #include "scope_info.h"
+#include "zone_profiler.h"
+#include "worker_thread.h"
 #include <array>
 #include <list>
 #include <set>
@@ -835,11 +837,49 @@ void SetupTileLoopCounts()
 	if (accumulator > 0) _tile_loop_counts[0]++;
 }
 
+/** Minimum number of tiles in a tile loop batch, smaller batches are not worth handing to a worker thread */
+static const uint TILE_LOOP_MIN_BATCH_SIZE = 4096;
+/** Maximum number of tile loop batches */
+static const uint TILE_LOOP_MAX_BATCHES = 8;
+
+/** Consecutive run of tiles of a tile loop iteration, whose TileLoopLocalProcs are run on one thread */
+struct TileLoopBatch {
+	const TileIndex *begin;              ///< First tile of the batch
+	const TileIndex *end;                ///< End of the tiles of the batch
+	std::vector<TileIndex> serial_tiles; ///< Tiles of the batch which still need their TileLoopProc to be called, in tile loop order
+
+	void RunLocal()
+	{
+		this->serial_tiles.clear();
+		for (const TileIndex *it = this->begin; it != this->end; ++it) {
+			const TileIndex tile = *it;
+			TileLoopLocalProc *proc = _tile_type_procs[GetTileType(tile)]->tile_loop_local_proc;
+			if (proc == nullptr || !proc(tile)) this->serial_tiles.push_back(tile);
+		}
+	}
+};
+
+/** State of the tile loop batches run on worker threads */
+struct TileLoopBatchJobs {
+	std::mutex lock;
+	std::condition_variable done_cv;
+	uint active = 0; ///< Number of batches still running on worker threads
+};
+
+static std::vector<TileIndex> _tile_loop_tiles;
+static std::array<TileLoopBatch, TILE_LOOP_MAX_BATCHES> _tile_loop_batches;
+
 /**
  * Gradually iterate over all tiles on the map, calling their TileLoopProcs once every 256 ticks.
+ *
+ * The TileLoopLocalProcs of the tiles of one iteration are run first, in batches which may be run in parallel.
+ * Then the TileLoopProcs of the remaining tiles are run in order on this thread.
+ * As the local procs only affect their own tile, the outcome does not depend on the number of batches.
  */
 void RunTileLoop(bool apply_day_length)
 {
+	ZONE_PROFILE("RunTileLoop");
+
 	/* We update every tile every 256 ticks, so divide the map size by 2^8 = 256 */
 	uint count;
 	if (apply_day_length && _settings_game.economy.day_length_factor > 1) {
@@ -865,14 +905,47 @@ void RunTileLoop(bool apply_day_length)
 		count--;
 	}
 
-	while (count--) {
-		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+	_tile_loop_tiles.resize(count);
+	for (TileIndex &t : _tile_loop_tiles) {
+		t = tile;
 
 		/* Get the next tile in sequence using a Galois LFSR. */
 		tile = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
 	}
-
 	_cur_tileloop_tile = tile;
+
+	const uint batches = Clamp<uint>(count / TILE_LOOP_MIN_BATCH_SIZE, 1, TILE_LOOP_MAX_BATCHES);
+	const TileIndex *begin = _tile_loop_tiles.data();
+	for (uint i = 0; i < batches; i++) {
+		_tile_loop_batches[i].begin = begin + ((uint64)count * i / batches);
+		_tile_loop_batches[i].end = begin + ((uint64)count * (i + 1) / batches);
+	}
+
+	if (batches > 1) {
+		TileLoopBatchJobs jobs;
+		jobs.active = batches - 1;
+		for (uint i = 1; i < batches; i++) {
+			_general_worker_pool.EnqueueJob([](void *data1, void *data2, void *data3) {
+				static_cast<TileLoopBatch *>(data2)->RunLocal();
+				TileLoopBatchJobs *jobs = static_cast<TileLoopBatchJobs *>(data1);
+				std::lock_guard<std::mutex> lk(jobs->lock);
+				if (--jobs->active == 0) jobs->done_cv.notify_all();
+			}, &jobs, &_tile_loop_batches[i]);
+		}
+		_tile_loop_batches[0].RunLocal();
+
+		std::unique_lock<std::mutex> lk(jobs.lock);
+		jobs.done_cv.wait(lk, [&]() { return jobs.active == 0; });
+	} else {
+		_tile_loop_batches[0].RunLocal();
+	}
+
+	for (uint i = 0; i < batches; i++) {
+		for (TileIndex t : _tile_loop_batches[i].serial_tiles) {
+			tile = t;
+			_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+		}
+	}
 }
 
 void RunAuxiliaryTileLoop()
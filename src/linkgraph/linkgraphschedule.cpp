@@ -16,6 +16,7 @@
 #include "../framerate_type.h"
 #include "../command_func.h"
 #include "../network/network.h"
+#include "../zone_profiler.h"
 #include <algorithm>
 
 #include "../safeguards.h"
@@ -152,6 +153,8 @@ void LinkGraphSchedule::JoinNext()
  */
 /* static */ void LinkGraphSchedule::Run(LinkGraphJob *job)
 {
+	ZONE_PROFILE("LinkGraphJob");
+
 	for (uint i = 0; i < lengthof(instance.handlers); ++i) {
 		if (job->IsJobAborted()) return;
 		instance.handlers[i]->Run(*job);
@@ -14,6 +14,8 @@
 #include "string_func.h"
 #include "rail_map.h"
 #include "tunnelbridge_map.h"
+#include "animated_tile_func.h"
+#include "pathfinder/water_regions.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 #include <array>
 #include <deque>
@@ -81,6 +83,8 @@ void AllocateMap(uint size_x, uint size_y)
 
 	_m = CallocT<Tile>(_map_size);
 	_me = CallocT<TileExtended>(_map_size);
+
+	InitializeWaterRegions();
 }
 
 
@@ -609,4 +613,7 @@ void DumpMapStats(char *b, const char *last)
 		if (it.first & TBB_SIGNALLED_BIDI) b = strecpy(b, ", bidi", last, true);
 		b += seprintf(b, last, ": %u\n", it.second);
 	}
+
+	b += seprintf(b, last, "\n");
+	b = DumpAnimatedTileStats(b, last);
 }
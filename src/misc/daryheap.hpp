@@ -0,0 +1,229 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file daryheap.hpp D-ary heap implementation. */
+
+#ifndef DARYHEAP_HPP
+#define DARYHEAP_HPP
+
+#include "../core/alloc_func.hpp"
+
+/**
+ * D-ary Heap as C++ template.
+ *  This has the same interface as CBinaryHeapT, but each node of the tree has
+ *  D children instead of two. This makes the tree shallower, and the children
+ *  of a node are adjacent in memory, which makes removing the smallest item
+ *  cheaper for the large heaps used by the pathfinders.
+ *
+ * @par Usage information:
+ * Item of the heap should support the 'lower-than' operator '<'.
+ *
+ * @par Implementation notes:
+ * Like CBinaryHeapT, the first item is never used, so that the first item is at index 1.
+ *  The children of the item at index i are at indices (i - 1) * D + 2 to (i - 1) * D + D + 1.
+ *
+ * @tparam T Type of the items stored in the heap
+ * @tparam D Number of children of each node
+ */
+template <class T, uint D = 4>
+class CDAryHeapT {
+	static_assert(D >= 2);
+
+private:
+	uint items;    ///< Number of items in the heap
+	uint capacity; ///< Maximum number of items the heap can hold
+	T **data;      ///< The pointer to the heap item pointers
+
+	static inline uint FirstChild(uint index) { return (index - 1) * D + 2; }
+	static inline uint Parent(uint index) { return (index - 2) / D + 1; }
+
+public:
+	/**
+	 * Create a d-ary heap.
+	 * @param max_items The initial limit of the heap
+	 */
+	explicit CDAryHeapT(uint max_items)
+		: items(0)
+		, capacity(max_items)
+	{
+		this->data = MallocT<T *>(max_items + 1);
+	}
+
+	~CDAryHeapT()
+	{
+		this->Clear();
+		free(this->data);
+		this->data = nullptr;
+	}
+
+protected:
+	/**
+	 * Get position for fixing a gap (downwards).
+	 * @param gap The position of the gap
+	 * @param item The proposed item for filling the gap
+	 * @return The (gap)position where the item fits
+	 */
+	inline uint HeapifyDown(uint gap, T *item)
+	{
+		dbg_assert(gap != 0);
+
+		for (uint child = FirstChild(gap); child <= this->items; child = FirstChild(gap)) {
+			/* choose the smallest child */
+			const uint last_child = std::min(child + D - 1, this->items);
+			uint best = child;
+			for (uint i = child + 1; i <= last_child; i++) {
+				if (*this->data[i] < *this->data[best]) best = i;
+			}
+			/* the smallest child is still bigger or same as the item => we are done */
+			if (!(*this->data[best] < *item)) break;
+
+			this->data[gap] = this->data[best];
+			gap = best;
+		}
+		return gap;
+	}
+
+	/**
+	 * Get position for fixing a gap (upwards).
+	 * @param gap The position of the gap
+	 * @param item The proposed item for filling the gap
+	 * @return The (gap)position where the item fits
+	 */
+	inline uint HeapifyUp(uint gap, T *item)
+	{
+		dbg_assert(gap != 0);
+
+		while (gap > 1) {
+			const uint parent = Parent(gap);
+			if (!(*item < *this->data[parent])) break;
+			this->data[gap] = this->data[parent];
+			gap = parent;
+		}
+		return gap;
+	}
+
+public:
+	/** Get the number of items stored in the priority queue. */
+	inline uint Length() const
+	{
+		return this->items;
+	}
+
+	/** Test if the priority queue is empty. */
+	inline bool IsEmpty() const
+	{
+		return this->items == 0;
+	}
+
+	/** Test if the priority queue is full. */
+	inline bool IsFull() const
+	{
+		return this->items >= this->capacity;
+	}
+
+	/** Get the smallest item in the heap. */
+	inline T *Begin()
+	{
+		dbg_assert(!this->IsEmpty());
+		return this->data[1];
+	}
+
+	/**
+	 * Get the LAST item in the heap.
+	 * @note The last item is not necessary the biggest!
+	 */
+	inline T *End()
+	{
+		return this->data[1 + this->items];
+	}
+
+	/**
+	 * Insert new item into the priority queue, maintaining heap order.
+	 * @param new_item The pointer to the new item
+	 */
+	inline void Include(T *new_item)
+	{
+		if (this->IsFull()) {
+			assert(this->capacity < UINT_MAX / 2);
+
+			this->capacity *= 2;
+			this->data = ReallocT<T*>(this->data, this->capacity + 1);
+		}
+
+		/* Make place for new item. A gap is now at the end of the tree. */
+		uint gap = this->HeapifyUp(++items, new_item);
+		this->data[gap] = new_item;
+	}
+
+	/**
+	 * Remove and return the smallest (and also first) item from the priority queue.
+	 * @return The pointer to the removed item
+	 */
+	inline T *Shift()
+	{
+		dbg_assert(!this->IsEmpty());
+
+		T *first = this->Begin();
+
+		this->items--;
+		/* at index 1 we have a gap now */
+		T *last = this->End();
+		uint gap = this->HeapifyDown(1, last);
+		/* move last item to the proper place */
+		if (!this->IsEmpty()) this->data[gap] = last;
+
+		return first;
+	}
+
+	/**
+	 * Remove item at given index from the priority queue.
+	 * @param index The position of the item in the heap
+	 */
+	inline void Remove(uint index)
+	{
+		if (index < this->items) {
+			dbg_assert(index != 0);
+			this->items--;
+			/* at position index we have a gap now */
+
+			T *last = this->End();
+			/* Fix the tree up and downwards */
+			uint gap = this->HeapifyUp(index, last);
+			gap = this->HeapifyDown(gap, last);
+			/* move last item to the proper place */
+			if (!this->IsEmpty()) this->data[gap] = last;
+		} else {
+			dbg_assert(index == this->items);
+			this->items--;
+		}
+	}
+
+	/**
+	 * Search for an item in the priority queue.
+	 *  Matching is done by comparing address of the item.
+	 * @param item The reference to the item
+	 * @return The index of the item or zero if not found
+	 */
+	inline uint FindIndex(const T &item) const
+	{
+		for (uint i = 1; i <= this->items; i++) {
+			if (this->data[i] == &item) return i;
+		}
+		return 0;
+	}
+
+	/**
+	 * Make the priority queue empty.
+	 * All remaining items will remain untouched.
+	 */
+	inline void Clear()
+	{
+		this->items = 0;
+	}
+};
+
+#endif /* DARYHEAP_HPP */
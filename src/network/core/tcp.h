@@ -74,6 +74,12 @@ public:
 	 */
 	bool HasSendQueue() { return !this->packet_queue.empty(); }
 
+	/**
+	 * Get the number of packets awaiting delivery.
+	 * @return The length of the send queue.
+	 */
+	size_t GetSendQueueSize() const { return this->packet_queue.size(); }
+
 	NetworkTCPSocketHandler(SOCKET s = INVALID_SOCKET);
 	~NetworkTCPSocketHandler();
 };
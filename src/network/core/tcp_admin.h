@@ -60,6 +60,7 @@ enum PacketAdminType {
 	ADMIN_PACKET_SERVER_GAMESCRIPT,      ///< The server gives the admin information from the GameScript in JSON.
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
+	ADMIN_PACKET_SERVER_METRICS,         ///< The server sends a batched frame of performance metrics.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -83,6 +84,7 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_METRICS,         ///< The admin would like to have performance metrics frames.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -98,6 +100,19 @@ enum AdminUpdateFrequency {
 };
 DECLARE_ENUM_AS_BIT_SET(AdminUpdateFrequency)
 
+/** Object counts reported in #ADMIN_PACKET_SERVER_METRICS. */
+enum AdminMetricsCount {
+	ADMIN_METRICS_VEHICLES,        ///< Number of vehicles.
+	ADMIN_METRICS_STATIONS,        ///< Number of stations and waypoints.
+	ADMIN_METRICS_CARGO_PACKETS,   ///< Number of cargo packets.
+	ADMIN_METRICS_ORDERS,          ///< Number of orders.
+	ADMIN_METRICS_TOWNS,           ///< Number of towns.
+	ADMIN_METRICS_INDUSTRIES,      ///< Number of industries.
+	ADMIN_METRICS_LINK_GRAPHS,     ///< Number of link graphs.
+	ADMIN_METRICS_LINK_GRAPH_JOBS, ///< Number of running link graph jobs.
+	ADMIN_METRICS_END,             ///< Sentinel for end.
+};
+
 /** Reasons for removing a company - communicated to admins. */
 enum AdminCompanyRemoveReason {
 	ADMIN_CRR_MANUAL,    ///< The company is manually removed.
@@ -137,6 +152,7 @@ protected:
 	 * Register updates to be sent at certain frequencies (as announced in the PROTOCOL packet):
 	 * uint16  Update type (see #AdminUpdateType). Note integer type - see "Certain Packet Information" in docs/admin_network.md.
 	 * uint16  Update frequency (see #AdminUpdateFrequency), setting #ADMIN_FREQUENCY_POLL is always ignored.
+	 * uint16  Optional, only for #ADMIN_UPDATE_METRICS: interval in ticks between automatic metrics frames.
 	 * @param p The packet that was just received.
 	 * @return The state the network should have.
 	 */
@@ -489,6 +505,32 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_RCON_END(Packet *p);
 
+	/**
+	 * Send a batched frame of performance metrics, covering the ticks since the previous frame.
+	 * uint32  Frame counter at the time of sending.
+	 * uint16  Number of ticks covered by this frame.
+	 * uint8   Number of performance elements to follow.
+	 * These four fields are repeated for each performance element:
+	 * uint8   ID of the performance element (PerformanceElement).
+	 * uint16  Number of samples of the element within the covered ticks.
+	 * uint32  Total time spent in the element, in microseconds.
+	 * uint32  Longest single sample of the element, in microseconds.
+	 * uint8   Number of object counts to follow.
+	 * These two fields are repeated for each object count:
+	 * uint8   ID of the object count (see #AdminMetricsCount).
+	 * uint32  Number of objects.
+	 * uint16  Number of connected clients.
+	 * uint32  Total number of packets queued for sending to clients.
+	 * uint16  Largest number of packets queued for sending to a single client.
+	 *
+	 * NOTICE: Performance element IDs are not stable and will not be
+	 *         treated as such. Do not rely on IDs to be constant
+	 *         across different versions / revisions of OpenTTD.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_METRICS(Packet *p);
+
 	NetworkRecvStatus HandlePacket(Packet *p);
 public:
 	NetworkRecvStatus CloseConnection(bool error = true) override;
@@ -21,6 +21,15 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../framerate_type.h"
+#include "../vehicle_base.h"
+#include "../station_base.h"
+#include "../cargopacket.h"
+#include "../order_base.h"
+#include "../town.h"
+#include "../industry.h"
+#include "../linkgraph/linkgraph.h"
+#include "../linkgraph/linkgraphjob.h"
 
 #include "../safeguards.h"
 
@@ -40,6 +49,9 @@ INSTANTIATE_POOL_METHODS(NetworkAdminSocket)
 /** The timeout for authorisation of the client. */
 static const std::chrono::seconds ADMIN_AUTHORISATION_TIMEOUT(10);
 
+/** The default interval in ticks between automatic metrics frames. */
+static const uint16 ADMIN_METRICS_DEFAULT_INTERVAL = DAY_TICKS;
+
 
 /** Frequencies, which may be registered for a certain update type. */
 static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
@@ -53,6 +65,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_METRICS
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -66,6 +79,8 @@ ServerNetworkAdminSocketHandler::ServerNetworkAdminSocketHandler(SOCKET s) : Net
 	_network_admins_connected++;
 	this->status = ADMIN_STATUS_INACTIVE;
 	this->connect_time = std::chrono::steady_clock::now();
+	this->metrics_interval = ADMIN_METRICS_DEFAULT_INTERVAL;
+	this->metrics_last_frame = _frame_counter;
 }
 
 /**
@@ -439,6 +454,70 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send a batched frame of performance metrics, covering the ticks since the previous frame sent to this admin.
+ * Everything in here is either a cached count or a walk over at most a few hundred recorded samples,
+ * so the cost for the server does not depend on the size of the game.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendMetrics()
+{
+	/* The frame counter restarts when a new game is loaded, in that case there is nothing to cover yet. */
+	uint32 elapsed = _frame_counter >= this->metrics_last_frame ? _frame_counter - this->metrics_last_frame : 0;
+	uint16 ticks = static_cast<uint16>(std::min<uint32>(elapsed, UINT16_MAX));
+	this->metrics_last_frame = _frame_counter;
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_METRICS);
+
+	p->Send_uint32(_frame_counter);
+	p->Send_uint16(ticks);
+
+	static const PerformanceElement elements[] = {
+		PFE_GAMELOOP, PFE_GL_ECONOMY, PFE_GL_TRAINS, PFE_GL_ROADVEHS, PFE_GL_SHIPS, PFE_GL_AIRCRAFT,
+		PFE_GL_LANDSCAPE, PFE_GL_LINKGRAPH, PFE_ALLSCRIPTS, PFE_GAMESCRIPT,
+	};
+	p->Send_uint8(lengthof(elements));
+	for (PerformanceElement elem : elements) {
+		PerformanceSummary summary = GetPerformanceSummary(elem, ticks);
+		p->Send_uint8 (elem);
+		p->Send_uint16(static_cast<uint16>(std::min<uint>(summary.samples, UINT16_MAX)));
+		p->Send_uint32(static_cast<uint32>(std::min<TimingMeasurement>(summary.total, UINT32_MAX)));
+		p->Send_uint32(static_cast<uint32>(std::min<TimingMeasurement>(summary.peak, UINT32_MAX)));
+	}
+
+	const size_t counts[ADMIN_METRICS_END] = {
+		Vehicle::GetNumItems(),
+		BaseStation::GetNumItems(),
+		CargoPacket::GetNumItems(),
+		Order::GetNumItems(),
+		Town::GetNumItems(),
+		Industry::GetNumItems(),
+		LinkGraph::GetNumItems(),
+		LinkGraphJob::GetNumItems(),
+	};
+	p->Send_uint8(ADMIN_METRICS_END);
+	for (uint i = 0; i < ADMIN_METRICS_END; i++) {
+		p->Send_uint8 (i);
+		p->Send_uint32(static_cast<uint32>(counts[i]));
+	}
+
+	uint clients = 0;
+	size_t queued_total = 0;
+	size_t queued_max = 0;
+	for (const NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+		size_t queued = cs->GetSendQueueSize();
+		clients++;
+		queued_total += queued;
+		queued_max = std::max(queued_max, queued);
+	}
+	p->Send_uint16(static_cast<uint16>(std::min<uint>(clients, UINT16_MAX)));
+	p->Send_uint32(static_cast<uint32>(std::min<size_t>(queued_total, UINT32_MAX)));
+	p->Send_uint16(static_cast<uint16>(std::min<size_t>(queued_max, UINT16_MAX)));
+
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -693,6 +772,12 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_UPDATE_FREQUENC
 
 	if (type == ADMIN_UPDATE_CONSOLE) DebugReconsiderSendRemoteMessages();
 
+	if (type == ADMIN_UPDATE_METRICS) {
+		/* The interval is optional, admins which do not care get the default. */
+		if (p->CanReadFromPacket(sizeof(uint16))) this->metrics_interval = std::max<uint16>(1, p->Recv_uint16());
+		this->metrics_last_frame = _frame_counter;
+	}
+
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -753,6 +838,11 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_METRICS:
+			/* The admin is requesting the metrics since the last frame it received. */
+			this->SendMetrics();
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 1, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name.c_str(), this->admin_version.c_str());
@@ -1026,3 +1116,20 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 		}
 	}
 }
+
+/**
+ * Send (push) metrics frames to the admins that registered for automatic metrics updates and whose interval has expired.
+ * Called every tick on the server.
+ */
+void NetworkAdminMetricsTick()
+{
+	if (_network_admins_connected == 0) return;
+
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if ((as->update_frequency[ADMIN_UPDATE_METRICS] & ADMIN_FREQUENCY_AUTOMATIC) == 0) continue;
+		if (_frame_counter < as->metrics_last_frame) as->metrics_last_frame = _frame_counter;
+		if (_frame_counter - as->metrics_last_frame < as->metrics_interval) continue;
+
+		as->SendMetrics();
+	}
+}
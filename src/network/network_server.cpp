@@ -2128,6 +2128,8 @@ void NetworkServer_Tick(bool send_frame)
 #endif
 		}
 	}
+
+	NetworkAdminMetricsTick();
 }
 
 /** Yearly "callback". Called whenever the year changes. */
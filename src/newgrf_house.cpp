@@ -29,6 +29,16 @@
 #include "table/strings.h"
 
 static BuildingCounts<uint32> _building_counts;
+
+/** Log2 of the side length of the map blocks in which house tiles are counted */
+static const uint HOUSE_TILE_BLOCK_BITS = 4;
+/** Number of house tiles in each block of the map, see #MayHaveHouseTilesInArea */
+static std::vector<uint16> _house_tile_block_counts;
+
+static inline uint16 &GetHouseTileBlockCount(uint x, uint y)
+{
+	return _house_tile_block_counts[((y >> HOUSE_TILE_BLOCK_BITS) << (MapLogX() - HOUSE_TILE_BLOCK_BITS)) | (x >> HOUSE_TILE_BLOCK_BITS)];
+}
 static HouseClassMapping _class_mapping[HOUSE_CLASS_MAX];
 
 HouseOverrideManager _house_mngr(NEW_HOUSE_OFFSET, NUM_HOUSES, INVALID_HOUSE_ID);
@@ -125,6 +135,7 @@ HouseClassID AllocateHouseClassID(byte grf_class_id, uint32 grfid)
 void InitializeBuildingCounts()
 {
 	memset(&_building_counts, 0, sizeof(_building_counts));
+	_house_tile_block_counts.assign(MapSize() >> (2 * HOUSE_TILE_BLOCK_BITS), 0);
 
 	for (Town *t : Town::Iterate()) {
 		memset(&t->cache.building_counts, 0, sizeof(t->cache.building_counts));
@@ -136,11 +147,14 @@ void InitializeBuildingCounts()
  * Increase the count of a building when it has been added by a town.
  * @param t The town that the building is being built in
  * @param house_id The id of the house being added
+ * @param tile The tile of the house being added
  */
-void IncreaseBuildingCount(Town *t, HouseID house_id)
+void IncreaseBuildingCount(Town *t, HouseID house_id, TileIndex tile)
 {
 	HouseClassID class_id = HouseSpec::Get(house_id)->class_id;
 
+	GetHouseTileBlockCount(TileX(tile), TileY(tile))++;
+
 	t->cache.building_counts.id_count[house_id]++;
 	_building_counts.id_count[house_id]++;
 
@@ -155,11 +169,15 @@ void IncreaseBuildingCount(Town *t, HouseID house_id)
  * Decrease the number of a building when it is deleted.
  * @param t The town that the building was built in
  * @param house_id The id of the house being removed
+ * @param tile The tile of the house being removed
  */
-void DecreaseBuildingCount(Town *t, HouseID house_id)
+void DecreaseBuildingCount(Town *t, HouseID house_id, TileIndex tile)
 {
 	HouseClassID class_id = HouseSpec::Get(house_id)->class_id;
 
+	uint16 &block_count = GetHouseTileBlockCount(TileX(tile), TileY(tile));
+	if (block_count > 0) block_count--;
+
 	if (t->cache.building_counts.id_count[house_id] > 0) t->cache.building_counts.id_count[house_id]--;
 	if (_building_counts.id_count[house_id] > 0) _building_counts.id_count[house_id]--;
 
@@ -169,6 +187,31 @@ void DecreaseBuildingCount(Town *t, HouseID house_id)
 	if (_building_counts.class_count[class_id] > 0) _building_counts.class_count[class_id]--;
 }
 
+/**
+ * Check whether there may be any house tiles in an area, using the house tile counts of blocks of the map.
+ * This is much cheaper than checking the tiles of large areas.
+ * @param x0 Minimum X coordinate of the area, may be outside the map.
+ * @param y0 Minimum Y coordinate of the area, may be outside the map.
+ * @param x1 Maximum X coordinate of the area (inclusive), may be outside the map.
+ * @param y1 Maximum Y coordinate of the area (inclusive), may be outside the map.
+ * @return False if there are no house tiles in the area, true if there may be.
+ */
+bool MayHaveHouseTilesInArea(int x0, int y0, int x1, int y1)
+{
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min<int>(x1, MapMaxX());
+	y1 = std::min<int>(y1, MapMaxY());
+	if (x0 > x1 || y0 > y1) return false;
+
+	for (uint y = y0 & ~((1 << HOUSE_TILE_BLOCK_BITS) - 1); y <= (uint)y1; y += (1 << HOUSE_TILE_BLOCK_BITS)) {
+		for (uint x = x0 & ~((1 << HOUSE_TILE_BLOCK_BITS) - 1); x <= (uint)x1; x += (1 << HOUSE_TILE_BLOCK_BITS)) {
+			if (GetHouseTileBlockCount(x, y) > 0) return true;
+		}
+	}
+	return false;
+}
+
 /* virtual */ uint32 HouseScopeResolver::GetRandomBits() const
 {
 	/* Note: Towns build houses over houses. So during construction checks 'tile' may be a valid but unrelated house. */
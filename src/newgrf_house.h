@@ -137,8 +137,9 @@ struct HouseClassMapping {
 HouseClassID AllocateHouseClassID(byte grf_class_id, uint32 grfid);
 
 void InitializeBuildingCounts();
-void IncreaseBuildingCount(Town *t, HouseID house_id);
-void DecreaseBuildingCount(Town *t, HouseID house_id);
+void IncreaseBuildingCount(Town *t, HouseID house_id, TileIndex tile);
+void DecreaseBuildingCount(Town *t, HouseID house_id, TileIndex tile);
+bool MayHaveHouseTilesInArea(int x0, int y0, int x1, int y1);
 
 void DrawNewHouseTile(TileInfo *ti, HouseID house_id);
 void DrawNewHouseTileInGUI(int x, int y, HouseID house_id, bool ground);
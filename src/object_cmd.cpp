@@ -189,6 +189,7 @@ void BuildObject(ObjectType type, TileIndex tile, CompanyID owner, Town *town, u
 	}
 
 	Object::IncTypeCount(type);
+	if (type == OBJECT_HQ) InvalidateStationCatchmentAcceptance(ta);
 	if (spec->flags & OBJECT_FLAG_ANIMATION) TriggerObjectAnimation(o, OAT_BUILT, spec);
 }
 
@@ -225,9 +226,12 @@ void UpdateCompanyHQ(TileIndex tile, uint score)
 	if (score >= 520) val++;
 	if (score >= 720) val++;
 
+	if (GetCompanyHQSize(tile) >= val) return;
+
 	while (GetCompanyHQSize(tile) < val) {
 		IncreaseCompanyHQSize(tile);
 	}
+	InvalidateStationCatchmentAcceptance(Object::GetByTile(tile)->location);
 }
 
 /**
@@ -699,6 +703,7 @@ Foundation GetFoundation_Object(TileIndex tile, Slope tileh)
 static void ReallyClearObjectTile(Object *o)
 {
 	Object::DecTypeCount(o->type);
+	if (o->type == OBJECT_HQ) InvalidateStationCatchmentAcceptance(o->location);
 	for (TileIndex tile_cur : o->location) {
 		DeleteNewGRFInspectWindow(GSF_OBJECTS, tile_cur);
 
@@ -1247,4 +1252,5 @@ extern const TileTypeProcs _tile_type_object_procs = {
 	nullptr,                        // vehicle_enter_tile_proc
 	GetFoundation_Object,        // get_foundation_proc
 	TerraformTile_Object,        // terraform_tile_proc
+	nullptr,                     // tile_loop_local_proc
 };
@@ -91,6 +91,7 @@
 
 #include "linkgraph/linkgraphschedule.h"
 #include "tracerestrict.h"
+#include "zone_profiler.h"
 
 #include "3rdparty/cpp-btree/btree_set.h"
 
@@ -261,6 +262,8 @@ static void ShowHelp()
 		"  -p password         = Password to join server\n"
 		"  -P password         = Password to join company\n"
 		"  -D [ip][:port]      = Start dedicated server\n"
+		"  -B ticks            = Benchmark: run the game given with -g for this many\n"
+		"                        ticks without drawing, and write timings as JSON\n"
 		"  -l ip[:port]        = Redirect DEBUG()\n"
 #if !defined(_WIN32)
 		"  -f                  = Fork into the background (dedicated only)\n"
@@ -706,6 +709,7 @@ static const OptionData _options[] = {
 	 GETOPT_SHORT_NOVAL('h'),
 	 GETOPT_SHORT_NOVAL('Q'),
 	 GETOPT_SHORT_VALUE('J'),
+	 GETOPT_SHORT_VALUE('B'),
 	 GETOPT_SHORT_NOVAL('Z'),
 	GETOPT_END()
 };
@@ -854,6 +858,12 @@ int openttd_main(int argc, char *argv[])
 		case 'c': _config_file = mgo.opt; break;
 		case 'x': scanner->save_config = false; break;
 		case 'J': _quit_after_days = Clamp(atoi(mgo.opt), 0, INT_MAX); break;
+		case 'B':
+			musicdriver = "null";
+			sounddriver = "null";
+			videodriver = std::string("null:benchmark,ticks=") + std::to_string(Clamp(atoi(mgo.opt), 1, INT_MAX));
+			blitter = "null";
+			break;
 		case 'Z': {
 			CrashLog::VersionInfoLog();
 			return ret;
@@ -1984,6 +1994,8 @@ CommandCost CmdDesyncCheck(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
  */
 void StateGameLoop()
 {
+	ZONE_PROFILE("StateGameLoop");
+
 	if (!_networking || _network_server) {
 		StateGameLoop_LinkGraphPauseControl();
 	}
@@ -839,6 +839,8 @@ private:
 
 	std::vector<DispatchSchedule> dispatch_schedules; ///< Scheduled dispatch schedules
 
+	mutable btree::btree_map<uint32, CargoStationIDStackSet> next_stopping_station_cache; ///< NOSAVE: Next stopping stations, by start order index and last station visited.
+
 public:
 	/** Default constructor producing an invalid order list. */
 	OrderList(VehicleOrderID num_orders = INVALID_VEH_ORDER_ID)
@@ -897,6 +899,12 @@ public:
 
 	CargoMaskedStationIDStack GetNextStoppingStation(const Vehicle *v, CargoTypes cargo_mask, const Order *first = nullptr, uint hops = 0) const;
 	const Order *GetNextDecisionNode(const Order *next, uint hops, CargoTypes &cargo_mask) const;
+	const CargoStationIDStackSet &GetNextStoppingStationSet(const Vehicle *v) const;
+
+	/**
+	 * Must be called if any order in the list is modified, to discard the cached next stopping stations.
+	 */
+	inline void InvalidateNextStoppingStationCache() { this->next_stopping_station_cache.clear(); }
 
 	void InsertOrderAt(Order *new_order, int index);
 	void DeleteOrderAt(int index);
@@ -348,11 +348,14 @@ Order::Order(uint64 packed)
 
 /**
  *
- * Updates the widgets of a vehicle which contains the order-data
+ * Updates the widgets of a vehicle which contains the order-data,
+ * and discards the cached next stopping stations of its order list.
  *
  */
 void InvalidateVehicleOrder(const Vehicle *v, int data)
 {
+	if (v->orders != nullptr) v->orders->InvalidateNextStoppingStationCache();
+
 	SetWindowDirty(WC_VEHICLE_VIEW, v->index);
 	SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
 
@@ -441,6 +444,7 @@ void CargoStationIDStackSet::FillNextStoppingStation(const Vehicle *v, const Ord
 
 void OrderList::ReindexOrderList()
 {
+	this->InvalidateNextStoppingStationCache();
 	this->order_index.clear();
 	for (Order *o = this->first; o != nullptr; o = o->next) {
 		this->order_index.push_back(o);
@@ -472,6 +476,7 @@ void OrderList::Initialize(Order *chain, Vehicle *v)
 	this->timetable_duration = 0;
 	this->total_duration = 0;
 	this->order_index.clear();
+	this->InvalidateNextStoppingStationCache();
 
 	VehicleType type = v->type;
 	Owner owner = v->owner;
@@ -525,6 +530,7 @@ void OrderList::FreeChain(bool keep_orderlist)
 	}
 
 	if (keep_orderlist) {
+		this->InvalidateNextStoppingStationCache();
 		this->first = nullptr;
 		this->num_manual_orders = 0;
 		this->timetable_duration = 0;
@@ -633,7 +639,7 @@ const Order *OrderList::GetNextDecisionNode(const Order *next, uint hops, CargoT
  * @param hops Number of orders we have already looked at.
  * @return A CargoMaskedStationIDStack of the cargo mask the result is valid for, and the next stopping station or INVALID_STATION.
  * @pre The vehicle is currently loading and v->last_station_visited is meaningful.
- * @note This function may draw a random number. Don't use it from the GUI.
+ * @note The result only depends on the order list, v->cur_implicit_order_index and v->last_station_visited, see GetNextStoppingStationSet.
  */
 CargoMaskedStationIDStack OrderList::GetNextStoppingStation(const Vehicle *v, CargoTypes cargo_mask, const Order *first, uint hops) const
 {
@@ -708,6 +714,27 @@ CargoMaskedStationIDStack OrderList::GetNextStoppingStation(const Vehicle *v, Ca
 	return CargoMaskedStationIDStack(cargo_mask, next->GetDestination());
 }
 
+/**
+ * Get the next stations to stop at for each cargo, for a vehicle which is loading, using a cache of previous results.
+ * The result only depends on the orders in this list, the current implicit order index and the last station visited.
+ * @param v The vehicle we're looking at, which must use this order list.
+ * @return The next stopping stations of the vehicle.
+ */
+const CargoStationIDStackSet &OrderList::GetNextStoppingStationSet(const Vehicle *v) const
+{
+	const uint32 key = ((uint32)v->cur_implicit_order_index << 16) | v->last_station_visited;
+
+	auto iter = this->next_stopping_station_cache.find(key);
+	if (iter != this->next_stopping_station_cache.end()) return iter->second;
+
+	/* Don't let the cache grow without bound for very long order lists */
+	if (this->next_stopping_station_cache.size() >= 256) this->next_stopping_station_cache.clear();
+
+	CargoStationIDStackSet &set = this->next_stopping_station_cache[key];
+	set.FillNextStoppingStation(v, this);
+	return set;
+}
+
 /**
  * Insert a new order into the order chain.
  * @param new_order is the order to insert into the chain.
@@ -2351,6 +2378,8 @@ CommandCost CmdModifyOrder(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 			default: NOT_REACHED();
 		}
 
+		v->orders->InvalidateNextStoppingStationCache();
+
 		/* Update the windows and full load flags, also for vehicles that share the same order list */
 		Vehicle *u = v->FirstShared();
 		DeleteOrderWarnings(u);
@@ -2741,6 +2770,7 @@ CommandCost CmdOrderRefit(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 			order->SetDepotOrderType((OrderDepotTypeFlags)(order->GetDepotOrderType() & ~ODTFB_SERVICE));
 			order->SetDepotActionType((OrderDepotActionFlags)(order->GetDepotActionType() & ~(ODATFB_HALT | ODATFB_SELL)));
 		}
+		v->orders->InvalidateNextStoppingStationCache();
 
 		for (Vehicle *u = v->FirstShared(); u != nullptr; u = u->NextShared()) {
 			/* Update any possible open window of the vehicle */
@@ -3680,6 +3710,7 @@ CommandCost CmdMassChangeOrder(TileIndex tile, DoCommandFlag flags, uint32 p1, u
 							order = v->orders->GetOrderAt(index);
 							order->SetRefit(new_order.GetRefitCargo());
 							order->SetMaxSpeed(new_order.GetMaxSpeed());
+							v->orders->InvalidateNextStoppingStationCache();
 							if (wait_fixed) {
 								extern void SetOrderFixedWaitTime(Vehicle *v, VehicleOrderID order_number, uint32 wait_time, bool wait_timetabled);
 								SetOrderFixedWaitTime(v, index, new_order.GetWaitTime(), wait_timetabled);
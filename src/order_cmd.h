@@ -64,6 +64,7 @@ restart:
 			bool travel_timetabled = order->IsTravelTimetabled();
 			order->MakeDummy();
 			order->SetTravelTimetabled(travel_timetabled);
+			v->orders->InvalidateNextStoppingStationCache();
 
 			for (const Vehicle *w = v->FirstShared(); w != nullptr; w = w->NextShared()) {
 				/* In GUI, simulate by removing the order and adding it back */
@@ -41,6 +41,12 @@ static const int YAPF_INFINITE_PENALTY = 1000 * YAPF_TILE_LENGTH;
 /** Maximum length of ship path cache */
 static const int YAPF_SHIP_PATH_CACHE_LENGTH = 32;
 
+/** Number of water region patches ahead of the ship which are searched at tile level */
+static const uint YAPF_SHIP_WATER_REGION_LOOKAHEAD = 4;
+
+/** Maximum number of water region patches to expand when searching the water region graph */
+static const uint YAPF_SHIP_WATER_REGION_MAX_SEARCH_NODES = 1 << 16;
+
 /** Maximum segments of road vehicle path cache */
 static const int YAPF_ROADVEH_PATH_CACHE_SEGMENTS = 16;
 
@@ -0,0 +1,392 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.cpp Handles dividing the water in the map into regions of connected water tiles, for hierarchical ship pathfinding. */
+
+#include "../stdafx.h"
+#include "water_regions.h"
+#include "../map_func.h"
+#include "../tile_cmd.h"
+#include "../track_func.h"
+#include "../tunnelbridge_map.h"
+#include "../core/bitmath_func.hpp"
+#include "../3rdparty/robin_hood/robin_hood.h"
+
+#include <memory>
+#include <queue>
+#include <tuple>
+
+#include "../safeguards.h"
+
+static const uint WATER_REGION_NUMBER_OF_TILES = WATER_REGION_EDGE_LENGTH * WATER_REGION_EDGE_LENGTH;
+
+/**
+ * Water region: a square block of tiles, with the water tiles within it divided into patches of connected tiles.
+ * Regions are (re-)computed lazily, when first needed after being invalidated.
+ */
+struct WaterRegion {
+	std::unique_ptr<uint8[]> labels;                     ///< Patch label of each tile in the region, only allocated if there is more than one patch
+	uint16 edge_traversability[DIAGDIR_END];             ///< For each edge, bit i is set if the i-th tile along that edge can be left across the edge
+	uint8 num_patches;                                   ///< Number of patches in the region
+	bool valid;                                          ///< Whether the region is up to date
+	bool has_cross_region_aqueducts;                     ///< Whether any aqueduct in the region leads to another region
+};
+
+static std::vector<WaterRegion> _water_regions;
+
+static inline uint GetWaterRegionIndex(TileIndex tile)
+{
+	return ((TileY(tile) >> WATER_REGION_EDGE_LOG) << (MapLogX() - WATER_REGION_EDGE_LOG)) | (TileX(tile) >> WATER_REGION_EDGE_LOG);
+}
+
+static inline uint GetWaterRegionX(uint region_index)
+{
+	return region_index & ((MapSizeX() >> WATER_REGION_EDGE_LOG) - 1);
+}
+
+static inline uint GetWaterRegionY(uint region_index)
+{
+	return region_index >> (MapLogX() - WATER_REGION_EDGE_LOG);
+}
+
+static inline TileIndex GetWaterRegionNorthTile(uint region_index)
+{
+	return TileXY(GetWaterRegionX(region_index) << WATER_REGION_EDGE_LOG, GetWaterRegionY(region_index) << WATER_REGION_EDGE_LOG);
+}
+
+static inline uint GetWaterRegionLocalIndex(TileIndex tile)
+{
+	return ((TileY(tile) & (WATER_REGION_EDGE_LENGTH - 1)) << WATER_REGION_EDGE_LOG) | (TileX(tile) & (WATER_REGION_EDGE_LENGTH - 1));
+}
+
+/**
+ * Get the index of a tile along the edge of its region which is crossed when leaving the tile in the given direction.
+ * @param tile Tile on the edge.
+ * @param dir Direction in which the edge is crossed.
+ * @return Index along the edge.
+ */
+static inline uint GetWaterRegionEdgeIndex(TileIndex tile, DiagDirection dir)
+{
+	return (DiagDirToAxis(dir) == AXIS_X) ? (TileY(tile) & (WATER_REGION_EDGE_LENGTH - 1)) : (TileX(tile) & (WATER_REGION_EDGE_LENGTH - 1));
+}
+
+static inline TrackdirBits GetWaterTrackdirs(TileIndex tile)
+{
+	return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0));
+}
+
+static inline bool IsWaterAqueductExit(TileIndex tile, DiagDirection dir)
+{
+	return IsBridgeTile(tile) && GetTunnelBridgeTransportType(tile) == TRANSPORT_WATER && GetTunnelBridgeDirection(tile) == dir;
+}
+
+/**
+ * Get the tile which a ship reaches when leaving a tile in the given direction.
+ * @param tile Tile being left.
+ * @param dir Direction in which the tile is left.
+ * @return Tile reached, or INVALID_TILE if that is off the map.
+ */
+static TileIndex GetWaterExitTile(TileIndex tile, DiagDirection dir)
+{
+	if (IsWaterAqueductExit(tile, dir)) return GetOtherTunnelBridgeEnd(tile);
+
+	TileIndexDiffC diff = TileIndexDiffCByDiagDir(dir);
+	return TileAddWrap(tile, diff.x, diff.y);
+}
+
+/** Reset all water regions, must be called whenever the map is (re-)allocated. */
+void InitializeWaterRegions()
+{
+	_water_regions.clear();
+	_water_regions.shrink_to_fit();
+	_water_regions.resize((MapSizeX() >> WATER_REGION_EDGE_LOG) * (MapSizeY() >> WATER_REGION_EDGE_LOG));
+}
+
+/**
+ * Mark the water region containing a tile as needing to be recomputed.
+ * @param tile Tile which has changed.
+ */
+void InvalidateWaterRegion(TileIndex tile)
+{
+	uint index = GetWaterRegionIndex(tile);
+	if (index < _water_regions.size()) _water_regions[index].valid = false;
+}
+
+/**
+ * Mark the water regions of all tiles whose slope depends on the height of the given tile corner as needing to be recomputed.
+ * @param tile Tile whose (northern corner) height has changed.
+ */
+void InvalidateWaterRegionsAroundTileCorner(TileIndex tile)
+{
+	InvalidateWaterRegion(tile);
+
+	/* The slope of the tiles to the north also depend on this corner, only the region boundaries need checking. */
+	uint x = TileX(tile);
+	uint y = TileY(tile);
+	if ((x & (WATER_REGION_EDGE_LENGTH - 1)) == 0 && x > 0) InvalidateWaterRegion(TileXY(x - 1, y));
+	if ((y & (WATER_REGION_EDGE_LENGTH - 1)) == 0 && y > 0) {
+		InvalidateWaterRegion(TileXY(x, y - 1));
+		if (x > 0) InvalidateWaterRegion(TileXY(x - 1, y - 1));
+	}
+}
+
+/**
+ * Divide the water tiles of a region into patches of connected tiles.
+ * @param region_index Index of the region.
+ * @param region The region.
+ */
+static void UpdateWaterRegion(uint region_index, WaterRegion &region)
+{
+	const TileIndex north = GetWaterRegionNorthTile(region_index);
+
+	TrackdirBits trackdirs[WATER_REGION_NUMBER_OF_TILES];
+	for (uint i = 0; i < WATER_REGION_NUMBER_OF_TILES; i++) {
+		trackdirs[i] = GetWaterTrackdirs(north + TileXY(i & (WATER_REGION_EDGE_LENGTH - 1), i >> WATER_REGION_EDGE_LOG));
+	}
+
+	uint8 labels[WATER_REGION_NUMBER_OF_TILES] = {};
+	uint16 stack[WATER_REGION_NUMBER_OF_TILES];
+	uint8 num_patches = 0;
+
+	for (DiagDirection dir = DIAGDIR_BEGIN; dir != DIAGDIR_END; dir++) region.edge_traversability[dir] = 0;
+	region.has_cross_region_aqueducts = false;
+
+	for (uint start = 0; start < WATER_REGION_NUMBER_OF_TILES; start++) {
+		if (trackdirs[start] == TRACKDIR_BIT_NONE || labels[start] != 0) continue;
+
+		const uint8 label = ++num_patches;
+		labels[start] = label;
+		uint stack_size = 0;
+		stack[stack_size++] = start;
+
+		/* Flood fill the patch, each tile is pushed at most once as it is labelled when pushed. */
+		while (stack_size > 0) {
+			const uint local = stack[--stack_size];
+			const TileIndex tile = north + TileXY(local & (WATER_REGION_EDGE_LENGTH - 1), local >> WATER_REGION_EDGE_LOG);
+
+			uint exit_dirs = 0;
+			for (TrackdirBits tdb = trackdirs[local]; tdb != TRACKDIR_BIT_NONE; tdb = KillFirstBit(tdb)) {
+				SetBit(exit_dirs, TrackdirToExitdir((Trackdir)FindFirstBit2x64(tdb)));
+			}
+
+			for (DiagDirection dir = DIAGDIR_BEGIN; dir != DIAGDIR_END; dir++) {
+				if (!HasBit(exit_dirs, dir)) continue;
+
+				const TileIndex next = GetWaterExitTile(tile, dir);
+				if (next == INVALID_TILE) continue;
+
+				if (GetWaterRegionIndex(next) != region_index) {
+					if (IsWaterAqueductExit(tile, dir)) {
+						region.has_cross_region_aqueducts = true;
+					} else {
+						SetBit(region.edge_traversability[dir], GetWaterRegionEdgeIndex(tile, dir));
+					}
+					continue;
+				}
+
+				const uint next_local = GetWaterRegionLocalIndex(next);
+				if (labels[next_local] != 0 || (trackdirs[next_local] & DiagdirReachesTrackdirs(dir)) == TRACKDIR_BIT_NONE) continue;
+				labels[next_local] = label;
+				stack[stack_size++] = next_local;
+			}
+		}
+	}
+
+	region.num_patches = num_patches;
+	if (num_patches > 1) {
+		if (region.labels == nullptr) region.labels.reset(new uint8[WATER_REGION_NUMBER_OF_TILES]);
+		std::copy(std::begin(labels), std::end(labels), region.labels.get());
+	} else {
+		region.labels.reset();
+	}
+	region.valid = true;
+}
+
+static inline WaterRegion &GetUpdatedWaterRegion(uint region_index)
+{
+	WaterRegion &region = _water_regions[region_index];
+	if (!region.valid) UpdateWaterRegion(region_index, region);
+	return region;
+}
+
+/**
+ * Get the patch label of a tile within an up to date region.
+ * @param region The region containing the tile.
+ * @param tile The tile.
+ * @return Patch label, or 0 if the tile is not part of any patch.
+ */
+static inline uint8 GetWaterRegionPatchLabel(const WaterRegion &region, TileIndex tile)
+{
+	if (region.num_patches == 0) return 0;
+	if (region.labels != nullptr) return region.labels[GetWaterRegionLocalIndex(tile)];
+
+	/* With only a single patch, all traversable tiles are part of it. */
+	return GetWaterTrackdirs(tile) != TRACKDIR_BIT_NONE ? 1 : 0;
+}
+
+/**
+ * Get the water region patch which a tile is part of.
+ * @param tile The tile.
+ * @return The patch key, or INVALID_WATER_REGION_PATCH if ships can not use the tile.
+ */
+WaterRegionPatchKey GetWaterRegionPatchKey(TileIndex tile)
+{
+	const uint region_index = GetWaterRegionIndex(tile);
+	const uint8 label = GetWaterRegionPatchLabel(GetUpdatedWaterRegion(region_index), tile);
+	if (label == 0) return INVALID_WATER_REGION_PATCH;
+	return (region_index << 8) | label;
+}
+
+/**
+ * Get the tile area of the region which a water region patch is part of.
+ * @param key The patch.
+ * @return Tile area of the region.
+ */
+TileArea GetWaterRegionPatchArea(WaterRegionPatchKey key)
+{
+	return TileArea(GetWaterRegionNorthTile(key >> 8), WATER_REGION_EDGE_LENGTH, WATER_REGION_EDGE_LENGTH);
+}
+
+static inline void AddUniqueWaterRegionPatch(std::vector<WaterRegionPatchKey> &keys, WaterRegionPatchKey key)
+{
+	if (std::find(keys.begin(), keys.end(), key) == keys.end()) keys.push_back(key);
+}
+
+/**
+ * Get the water region patches which ships can reach directly from a water region patch, across the region edges or using aqueducts.
+ * @param key The patch.
+ * @param[out] neighbours Neighbouring patches, in no particular order.
+ */
+void GetWaterRegionPatchNeighbours(WaterRegionPatchKey key, std::vector<WaterRegionPatchKey> &neighbours)
+{
+	neighbours.clear();
+
+	const uint region_index = key >> 8;
+	const uint8 label = key & 0xFF;
+	const WaterRegion &region = GetUpdatedWaterRegion(region_index);
+	const TileIndex north = GetWaterRegionNorthTile(region_index);
+
+	for (DiagDirection dir = DIAGDIR_BEGIN; dir != DIAGDIR_END; dir++) {
+		for (uint bits = region.edge_traversability[dir]; bits != 0; bits = KillFirstBit(bits)) {
+			const uint index = FindFirstBit(bits);
+			const uint last = WATER_REGION_EDGE_LENGTH - 1;
+			TileIndex tile;
+			switch (dir) {
+				case DIAGDIR_NE: tile = north + TileXY(0, index); break;
+				case DIAGDIR_SE: tile = north + TileXY(index, last); break;
+				case DIAGDIR_SW: tile = north + TileXY(last, index); break;
+				case DIAGDIR_NW: tile = north + TileXY(index, 0); break;
+				default: NOT_REACHED();
+			}
+			if (GetWaterRegionPatchLabel(region, tile) != label) continue;
+
+			const TileIndex next = GetWaterExitTile(tile, dir);
+			if ((GetWaterTrackdirs(next) & DiagdirReachesTrackdirs(dir)) == TRACKDIR_BIT_NONE) continue;
+
+			const WaterRegionPatchKey next_key = GetWaterRegionPatchKey(next);
+			if (next_key != INVALID_WATER_REGION_PATCH) AddUniqueWaterRegionPatch(neighbours, next_key);
+		}
+	}
+
+	if (region.has_cross_region_aqueducts) {
+		for (TileIndex tile : GetWaterRegionPatchArea(key)) {
+			if (!IsBridgeTile(tile) || GetTunnelBridgeTransportType(tile) != TRANSPORT_WATER) continue;
+			if (GetWaterRegionPatchLabel(region, tile) != label) continue;
+
+			const TileIndex other_end = GetOtherTunnelBridgeEnd(tile);
+			if (GetWaterRegionIndex(other_end) == region_index) continue;
+
+			const WaterRegionPatchKey next_key = GetWaterRegionPatchKey(other_end);
+			if (next_key != INVALID_WATER_REGION_PATCH) AddUniqueWaterRegionPatch(neighbours, next_key);
+		}
+	}
+}
+
+/**
+ * Get the distance between two water regions, in units of regions.
+ * Crossing a region edge costs one, aqueducts spanning several regions cost the number of regions spanned.
+ */
+static inline uint GetWaterRegionDistance(uint region_a, uint region_b)
+{
+	return Delta(GetWaterRegionX(region_a), GetWaterRegionX(region_b)) + Delta(GetWaterRegionY(region_a), GetWaterRegionY(region_b));
+}
+
+/**
+ * Find a path of water region patches using A*.
+ * @param origin Patch to start at.
+ * @param destinations Patches to find a path to, sorted.
+ * @param max_nodes Maximum number of patches to expand.
+ * @param[out] path Patches of the found path, from the origin to the reached destination inclusive.
+ * @param[out] nodes_searched Number of patches expanded.
+ * @return Whether a path was found.
+ */
+bool FindWaterRegionPatchPath(WaterRegionPatchKey origin, const std::vector<WaterRegionPatchKey> &destinations, uint max_nodes, std::vector<WaterRegionPatchKey> &path, uint *nodes_searched)
+{
+	path.clear();
+	*nodes_searched = 0;
+	if (destinations.empty()) return false;
+
+	std::vector<uint> destination_regions;
+	for (WaterRegionPatchKey key : destinations) {
+		if (std::find(destination_regions.begin(), destination_regions.end(), key >> 8) == destination_regions.end()) destination_regions.push_back(key >> 8);
+	}
+	auto estimate = [&](WaterRegionPatchKey key) -> uint {
+		uint best = UINT_MAX;
+		for (uint region : destination_regions) best = std::min(best, GetWaterRegionDistance(key >> 8, region));
+		return best;
+	};
+
+	struct OpenNode {
+		uint estimate;
+		uint cost;
+		WaterRegionPatchKey key;
+
+		bool operator>(const OpenNode &other) const { return std::tie(this->estimate, this->key) > std::tie(other.estimate, other.key); }
+	};
+	struct VisitedNode {
+		WaterRegionPatchKey parent;
+		uint cost;
+		bool closed;
+	};
+
+	std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+	robin_hood::unordered_flat_map<WaterRegionPatchKey, VisitedNode> visited;
+	std::vector<WaterRegionPatchKey> neighbours;
+
+	open.push({ estimate(origin), 0, origin });
+	visited[origin] = { INVALID_WATER_REGION_PATCH, 0, false };
+
+	while (!open.empty()) {
+		const OpenNode current = open.top();
+		open.pop();
+
+		VisitedNode &current_visited = visited[current.key];
+		if (current_visited.closed || current.cost != current_visited.cost) continue;
+		current_visited.closed = true;
+
+		if (std::binary_search(destinations.begin(), destinations.end(), current.key)) {
+			for (WaterRegionPatchKey key = current.key; key != INVALID_WATER_REGION_PATCH; key = visited[key].parent) {
+				path.push_back(key);
+			}
+			std::reverse(path.begin(), path.end());
+			return true;
+		}
+
+		if (++(*nodes_searched) > max_nodes) return false;
+
+		GetWaterRegionPatchNeighbours(current.key, neighbours);
+		for (WaterRegionPatchKey next : neighbours) {
+			const uint cost = current.cost + GetWaterRegionDistance(current.key >> 8, next >> 8);
+			auto iter = visited.find(next);
+			if (iter != visited.end() && (iter->second.closed || iter->second.cost <= cost)) continue;
+			visited[next] = { current.key, cost, false };
+			open.push({ cost + estimate(next), cost, next });
+		}
+	}
+
+	return false;
+}
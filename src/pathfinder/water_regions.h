@@ -0,0 +1,36 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.h Handles dividing the water in the map into regions of connected water tiles, for hierarchical ship pathfinding. */
+
+#ifndef WATER_REGIONS_H
+#define WATER_REGIONS_H
+
+#include "../tile_type.h"
+#include "../tilearea_type.h"
+#include <vector>
+
+static const uint WATER_REGION_EDGE_LOG = 4;                              ///< Log2 of the edge length of a water region
+static const uint WATER_REGION_EDGE_LENGTH = 1 << WATER_REGION_EDGE_LOG;  ///< Edge length of a water region, in tiles
+
+/**
+ * Key of a water region patch: a set of water tiles within one water region, which are connected to each other.
+ * Bits 0..7 are the patch label within the region, the remaining bits are the water region index.
+ */
+typedef uint32 WaterRegionPatchKey;
+static const WaterRegionPatchKey INVALID_WATER_REGION_PATCH = UINT32_MAX;
+
+void InitializeWaterRegions();
+void InvalidateWaterRegion(TileIndex tile);
+void InvalidateWaterRegionsAroundTileCorner(TileIndex tile);
+
+WaterRegionPatchKey GetWaterRegionPatchKey(TileIndex tile);
+TileArea GetWaterRegionPatchArea(WaterRegionPatchKey key);
+void GetWaterRegionPatchNeighbours(WaterRegionPatchKey key, std::vector<WaterRegionPatchKey> &neighbours);
+bool FindWaterRegionPatchPath(WaterRegionPatchKey origin, const std::vector<WaterRegionPatchKey> &destinations, uint max_nodes, std::vector<WaterRegionPatchKey> &path, uint *nodes_searched);
+
+#endif /* WATER_REGIONS_H */
@@ -10,35 +10,308 @@
 #ifndef NODELIST_HPP
 #define NODELIST_HPP
 
-#include "../../misc/array.hpp"
-#include "../../misc/hashtable.hpp"
-#include "../../misc/binaryheap.hpp"
+#include "../../misc/daryheap.hpp"
+#include "../../string_func.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Storage for the nodes of a node list.
+ *  Nodes are allocated in blocks which are never moved, so pointers to nodes stay valid.
+ *  Clearing does not free the blocks, so that they can be reused by the next search.
+ */
+template <class Titem_>
+class CNodeArenaT {
+	static_assert(std::is_trivially_destructible<Titem_>::value);
+
+	static const uint BLOCK_ITEMS = 4096;          ///< Number of items per block
+	static const uint MAX_RETAINED_BLOCKS = 64;    ///< Maximum number of blocks kept when clearing
+
+	std::vector<Titem_ *> m_blocks;                ///< Allocated blocks
+	uint m_count = 0;                              ///< Number of items in use
+
+public:
+	CNodeArenaT() = default;
+	CNodeArenaT(const CNodeArenaT &) = delete;
+	CNodeArenaT &operator=(const CNodeArenaT &) = delete;
+
+	~CNodeArenaT()
+	{
+		for (Titem_ *block : m_blocks) free(block);
+	}
+
+	/** Forget all items, freeing any blocks beyond MAX_RETAINED_BLOCKS */
+	inline void Clear()
+	{
+		m_count = 0;
+		while (m_blocks.size() > MAX_RETAINED_BLOCKS) {
+			free(m_blocks.back());
+			m_blocks.pop_back();
+		}
+	}
+
+	/** Return actual number of items */
+	inline uint Length() const
+	{
+		return m_count;
+	}
+
+	/** allocate and construct new item */
+	inline Titem_ *AppendC()
+	{
+		const uint block = m_count / BLOCK_ITEMS;
+		if (block == m_blocks.size()) m_blocks.push_back(MallocT<Titem_>(BLOCK_ITEMS));
+		Titem_ *item = m_blocks[block] + (m_count % BLOCK_ITEMS);
+		m_count++;
+		new (item) Titem_;
+		return item;
+	}
+
+	/** indexed access (non-const) */
+	inline Titem_ &operator[](uint index)
+	{
+		return m_blocks[index / BLOCK_ITEMS][index % BLOCK_ITEMS];
+	}
+
+	/** indexed access (const) */
+	inline const Titem_ &operator[](uint index) const
+	{
+		return m_blocks[index / BLOCK_ITEMS][index % BLOCK_ITEMS];
+	}
+
+	/** Helper for creating a human readable output of this data. */
+	template <typename D> void Dump(D &dmp) const
+	{
+		dmp.WriteValue("num_items", m_count);
+		for (uint i = 0; i < m_count; i++) {
+			char name[32];
+			seprintf(name, lastof(name), "item[%d]", i);
+			dmp.WriteStructT(name, &(*this)[i]);
+		}
+	}
+};
+
+/**
+ * Hash set of pointers to nodes, using open addressing with linear probing.
+ *  Each entry is tagged with a generation number, an entry is only in use if its
+ *  generation matches that of the set, so that clearing takes constant time.
+ */
+template <class Titem_>
+class CNodeHashSetT {
+	typedef typename Titem_::Key Key;
+
+	static const uint MAX_RETAINED_BITS = 17;      ///< Maximum number of hash bits kept when clearing
+
+	struct Entry {
+		uint32 generation;                         ///< Generation of the set in which this entry was last used
+		uint32 hash;                               ///< Full hash of the key of the item
+		Titem_ *item;                              ///< The item
+	};
+
+	std::vector<Entry> m_entries;                  ///< Entries, the number of entries is a power of two
+	uint m_initial_bits;                           ///< Number of hash bits to start with
+	uint m_bits;                                   ///< Number of hash bits, log2 of the number of entries
+	uint32 m_generation = 1;                       ///< Current generation
+	int m_num_items = 0;                           ///< Number of items in the set
+
+	/** Fibonacci hash of a key, the top bits are used to find the ideal position */
+	static inline uint32 Hash(const Key &key)
+	{
+		return (uint32)key.CalcHash() * 0x9E3779B9U;
+	}
+
+	inline uint IdealIndex(uint32 hash) const
+	{
+		return hash >> (32 - m_bits);
+	}
+
+	inline uint Mask() const
+	{
+		return (1 << m_bits) - 1;
+	}
+
+	inline bool IsUsed(const Entry &entry) const
+	{
+		return entry.generation == m_generation;
+	}
+
+	void Resize(uint bits)
+	{
+		std::vector<Entry> old_entries;
+		old_entries.swap(m_entries);
+		const uint32 old_generation = m_generation;
+
+		m_bits = bits;
+		m_entries.assign((size_t)1 << bits, Entry{ 0, 0, nullptr });
+		m_generation = 1;
+		for (const Entry &entry : old_entries) {
+			if (entry.generation != old_generation) continue;
+			uint index = IdealIndex(entry.hash);
+			while (IsUsed(m_entries[index])) index = (index + 1) & Mask();
+			m_entries[index] = { m_generation, entry.hash, entry.item };
+		}
+	}
+
+	/** Find the index of the entry with the given key, or -1 */
+	inline int FindIndex(const Key &key) const
+	{
+		const uint32 hash = Hash(key);
+		for (uint index = IdealIndex(hash);; index = (index + 1) & Mask()) {
+			const Entry &entry = m_entries[index];
+			if (!IsUsed(entry)) return -1;
+			if (entry.hash == hash && entry.item->GetKey() == key) return (int)index;
+		}
+	}
+
+	/** Remove the entry at the given index, moving later entries of the probe sequence back into the gap */
+	inline void RemoveIndex(uint gap)
+	{
+		for (uint index = (gap + 1) & Mask();; index = (index + 1) & Mask()) {
+			Entry &entry = m_entries[index];
+			if (!IsUsed(entry)) break;
+
+			/* The entry can fill the gap if the gap lies cyclically between its ideal position and its position */
+			const uint ideal = IdealIndex(entry.hash);
+			if (((index - ideal) & Mask()) >= ((index - gap) & Mask())) {
+				m_entries[gap] = entry;
+				gap = index;
+			}
+		}
+		m_entries[gap].generation = 0;
+		m_num_items--;
+	}
+
+public:
+	explicit CNodeHashSetT(uint bits) : m_initial_bits(bits)
+	{
+		Resize(bits);
+	}
+
+	/** item count */
+	inline int Count() const
+	{
+		return m_num_items;
+	}
+
+	/** forget all items */
+	inline void Clear()
+	{
+		m_num_items = 0;
+		if (m_bits > MAX_RETAINED_BITS) {
+			m_entries.clear();
+			Resize(m_initial_bits);
+			return;
+		}
+		m_generation++;
+		if (m_generation == 0) {
+			/* Generation counter wrapped, really clear the entries */
+			for (Entry &entry : m_entries) entry.generation = 0;
+			m_generation = 1;
+		}
+	}
+
+	/** item search */
+	inline Titem_ *Find(const Key &key) const
+	{
+		const int index = FindIndex(key);
+		return index < 0 ? nullptr : m_entries[index].item;
+	}
+
+	/** item search & removal */
+	inline Titem_ &Pop(const Key &key)
+	{
+		const int index = FindIndex(key);
+		assert(index >= 0);
+		Titem_ *item = m_entries[index].item;
+		RemoveIndex(index);
+		return *item;
+	}
+
+	/** item removal */
+	inline void Pop(Titem_ &item)
+	{
+		[[maybe_unused]] Titem_ &popped = Pop(item.GetKey());
+		dbg_assert(&popped == &item);
+	}
+
+	/** add one item */
+	inline void Push(Titem_ &new_item)
+	{
+		if ((uint)(m_num_items + 1) * 2 > (1U << m_bits)) Resize(m_bits + 1);
+
+		const uint32 hash = Hash(new_item.GetKey());
+		uint index = IdealIndex(hash);
+		while (IsUsed(m_entries[index])) {
+			dbg_assert(!(m_entries[index].hash == hash && m_entries[index].item->GetKey() == new_item.GetKey()));
+			index = (index + 1) & Mask();
+		}
+		m_entries[index] = { m_generation, hash, &new_item };
+		m_num_items++;
+	}
+};
 
 /**
  * Hash table based node list multi-container class.
  *  Implements open list, closed list and priority queue for A-star
  *  path finder.
+ *  The containers are kept in a per-thread pool when the node list is destroyed,
+ *  so that following searches can reuse the memory without allocating it again.
  */
 template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
 class CNodeList_HashTableT {
 public:
 	typedef Titem_ Titem;                                        ///< Make #Titem_ visible from outside of class.
 	typedef typename Titem_::Key Key;                            ///< Make Titem_::Key a property of this class.
-	typedef SmallArray<Titem_, 65536, 256> CItemArray;           ///< Type that we will use as item container.
-	typedef CHashTableT<Titem_, Thash_bits_open_  > COpenList;   ///< How pointers to open nodes will be stored.
-	typedef CHashTableT<Titem_, Thash_bits_closed_> CClosedList; ///< How pointers to closed nodes will be stored.
-	typedef CBinaryHeapT<Titem_> CPriorityQueue;                 ///< How the priority queue will be managed.
+	typedef CNodeArenaT<Titem_> CItemArray;                      ///< Type that we will use as item container.
+	typedef CNodeHashSetT<Titem_> COpenList;                     ///< How pointers to open nodes will be stored.
+	typedef CNodeHashSetT<Titem_> CClosedList;                   ///< How pointers to closed nodes will be stored.
+	typedef CDAryHeapT<Titem_, 4> CPriorityQueue;                ///< How the priority queue will be managed.
 
 protected:
-	CItemArray      m_arr;        ///< Here we store full item data (Titem_).
-	COpenList       m_open;       ///< Hash table of pointers to open item data.
-	CClosedList     m_closed;     ///< Hash table of pointers to closed item data.
-	CPriorityQueue  m_open_queue; ///< Priority queue of pointers to open item data.
-	Titem          *m_new_node;   ///< New open node under construction.
+	/** Containers of a node list, which are reused by later node lists on the same thread */
+	struct Storage {
+		CItemArray      arr;
+		COpenList       open;
+		CClosedList     closed;
+		CPriorityQueue  open_queue;
+
+		Storage() : open(Thash_bits_open_), closed(Thash_bits_closed_), open_queue(2048) {}
+
+		void Clear()
+		{
+			arr.Clear();
+			open.Clear();
+			closed.Clear();
+			open_queue.Clear();
+		}
+	};
+
+	static std::vector<std::unique_ptr<Storage>> &GetStoragePool()
+	{
+		static thread_local std::vector<std::unique_ptr<Storage>> pool;
+		return pool;
+	}
+
+	std::unique_ptr<Storage> m_storage; ///< Containers of this node list.
+	CItemArray     &m_arr;              ///< Here we store full item data (Titem_).
+	COpenList      &m_open;             ///< Hash table of pointers to open item data.
+	CClosedList    &m_closed;           ///< Hash table of pointers to closed item data.
+	CPriorityQueue &m_open_queue;       ///< Priority queue of pointers to open item data.
+	Titem          *m_new_node;         ///< New open node under construction.
+
+	static std::unique_ptr<Storage> AcquireStorage()
+	{
+		std::vector<std::unique_ptr<Storage>> &pool = GetStoragePool();
+		if (pool.empty()) return std::unique_ptr<Storage>(new Storage());
+		std::unique_ptr<Storage> storage = std::move(pool.back());
+		pool.pop_back();
+		return storage;
+	}
 
 public:
 	/** default constructor */
-	CNodeList_HashTableT() : m_open_queue(2048)
+	CNodeList_HashTableT() : m_storage(AcquireStorage()), m_arr(m_storage->arr), m_open(m_storage->open), m_closed(m_storage->closed), m_open_queue(m_storage->open_queue)
 	{
 		m_new_node = nullptr;
 	}
@@ -46,6 +319,8 @@ public:
 	/** destructor */
 	~CNodeList_HashTableT()
 	{
+		m_storage->Clear();
+		GetStoragePool().push_back(std::move(m_storage));
 	}
 
 	/** return number of open nodes */
@@ -17,7 +17,7 @@
 #include "../../misc/fixedsizearray.hpp"
 #include "../../misc/array.hpp"
 #include "../../misc/hashtable.hpp"
-#include "../../misc/binaryheap.hpp"
+#include "../../misc/daryheap.hpp"
 #include "../../misc/dbg_helpers.h"
 #include "nodelist.hpp"
 #include "../follow_track.hpp"
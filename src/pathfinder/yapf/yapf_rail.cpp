@@ -18,6 +18,7 @@
 #include "../../newgrf_station.h"
 #include "../../tracerestrict.h"
 #include "../../debug.h"
+#include "../../zone_profiler.h"
 
 #include "../../safeguards.h"
 
@@ -659,6 +660,8 @@ struct CYapfAnySafeTileRail2 : CYapfT<CYapfRail_TypesT<CYapfAnySafeTileRail2, CF
 
 Track YapfTrainChooseTrack(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
 {
+	ZONE_PROFILE("YapfTrainChooseTrack");
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseRailTrack)(const Train*, TileIndex, DiagDirection, TrackBits, bool&, bool, PBSTileInfo*, TileIndex*);
 	PfnChooseRailTrack pfnChooseRailTrack = &CYapfRail1::stChooseRailTrack;
@@ -12,6 +12,7 @@
 #include "yapf_node_road.hpp"
 #include "../../roadstop_base.h"
 #include "../../vehicle_func.h"
+#include "../../zone_profiler.h"
 
 #include "../../safeguards.h"
 
@@ -641,6 +642,8 @@ struct CYapfRoadAnyDepot2 : CYapfRoadCommon<CYapfRoad_TypesT<CYapfRoadAnyDepot2,
 
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache)
 {
+	ZONE_PROFILE("YapfRoadVehicleChooseTrack");
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseRoadTrack)(const RoadVehicle*, TileIndex, DiagDirection, bool &path_found, RoadVehPathCache &path_cache);
 	PfnChooseRoadTrack pfnChooseRoadTrack = &CYapfRoad2::stChooseRoadTrack; // default: ExitDir, allow 90-deg
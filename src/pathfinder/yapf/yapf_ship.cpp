@@ -11,9 +11,14 @@
 #include "../../ship.h"
 #include "../../industry.h"
 #include "../../vehicle_func.h"
+#include "../../station_base.h"
+#include "../water_regions.h"
 
 #include "yapf.hpp"
 #include "yapf_node_ship.hpp"
+#include "../../zone_profiler.h"
+
+#include <chrono>
 
 #include "../../safeguards.h"
 
@@ -31,6 +36,10 @@ protected:
 	TrackdirBits m_destTrackdirs;
 	StationID    m_destStation;
 
+	std::vector<WaterRegionPatchKey> m_corridor;                          ///< sorted water region patches the search is restricted to, empty if unrestricted
+	WaterRegionPatchKey m_intermediatePatch = INVALID_WATER_REGION_PATCH; ///< water region patch which also counts as destination, when only the start of a long region path is searched
+	TileArea     m_intermediateArea;                                      ///< tile area of the region of m_intermediatePatch
+
 public:
 	void SetDestination(const Ship *v)
 	{
@@ -45,6 +54,74 @@ public:
 		}
 	}
 
+	/**
+	 * Search the water region graph from the origin to the destination, and restrict
+	 * the tile level search to the water region patches along the start of the found path.
+	 * @param origin_tile Tile the search starts from.
+	 * @return Whether the tile level search has been restricted.
+	 */
+	bool SetWaterRegionCorridor(TileIndex origin_tile)
+	{
+		const WaterRegionPatchKey origin = GetWaterRegionPatchKey(origin_tile);
+		if (origin == INVALID_WATER_REGION_PATCH) return false;
+
+		std::vector<WaterRegionPatchKey> destinations;
+		if (m_destStation != INVALID_STATION) {
+			const Station *st = Station::GetIfValid(m_destStation);
+			if (st == nullptr) return false;
+			for (TileIndex tile : st->docking_station) {
+				if (!IsDockingTile(tile) || !IsShipDestinationTile(tile, m_destStation)) continue;
+				const WaterRegionPatchKey key = GetWaterRegionPatchKey(tile);
+				if (key != INVALID_WATER_REGION_PATCH) destinations.push_back(key);
+			}
+		} else {
+			const WaterRegionPatchKey key = GetWaterRegionPatchKey(m_destTile);
+			if (key != INVALID_WATER_REGION_PATCH) destinations.push_back(key);
+		}
+		if (destinations.empty()) return false;
+		std::sort(destinations.begin(), destinations.end());
+		destinations.erase(std::unique(destinations.begin(), destinations.end()), destinations.end());
+
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<WaterRegionPatchKey> path;
+		uint nodes_searched;
+		const bool found = FindWaterRegionPatchPath(origin, destinations, YAPF_SHIP_WATER_REGION_MAX_SEARCH_NODES, path, &nodes_searched);
+
+		if (found) {
+			/* Long paths are only searched at tile level up to a few patches ahead, the ship searches again when it gets there. */
+			const size_t end = std::min<size_t>(path.size(), YAPF_SHIP_WATER_REGION_LOOKAHEAD + 1);
+			if (end < path.size()) {
+				m_intermediatePatch = path[end - 1];
+				m_intermediateArea = GetWaterRegionPatchArea(m_intermediatePatch);
+			}
+
+			/* Include the neighbours of the path patches, so that the tile level path is not forced through narrow patches. */
+			std::vector<WaterRegionPatchKey> neighbours;
+			for (size_t i = 0; i < end; i++) {
+				m_corridor.push_back(path[i]);
+				GetWaterRegionPatchNeighbours(path[i], neighbours);
+				m_corridor.insert(m_corridor.end(), neighbours.begin(), neighbours.end());
+			}
+			std::sort(m_corridor.begin(), m_corridor.end());
+			m_corridor.erase(std::unique(m_corridor.begin(), m_corridor.end()), m_corridor.end());
+		}
+
+		if (_debug_yapf_level >= 3) {
+			const uint duration = (uint)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			DEBUG(yapf, 3, "[YAPFw] water regions: %s - %u patches searched - path %u patches - corridor %u patches - %u us",
+					found ? "found" : "not found", nodes_searched, (uint)path.size(), (uint)m_corridor.size(), duration);
+		}
+
+		return found;
+	}
+
+	/** Whether the tile level search may enter the given tile */
+	inline bool IsTileInWaterRegionCorridor(TileIndex tile) const
+	{
+		if (m_corridor.empty()) return true;
+		return std::binary_search(m_corridor.begin(), m_corridor.end(), GetWaterRegionPatchKey(tile));
+	}
+
 protected:
 	/** to access inherited path finder */
 	inline Tpf& Yapf()
@@ -61,6 +138,8 @@ public:
 
 	inline bool PfDetectDestinationTile(TileIndex tile, Trackdir trackdir)
 	{
+		if (m_intermediatePatch != INVALID_WATER_REGION_PATCH && m_intermediateArea.Contains(tile) && GetWaterRegionPatchKey(tile) == m_intermediatePatch) return true;
+
 		if (m_destStation != INVALID_STATION) {
 			return IsDockingTile(tile) && IsShipDestinationTile(tile, m_destStation);
 		}
@@ -87,6 +166,11 @@ public:
 		int y1 = 2 * TileY(tile) + dg_dir_to_y_offs[(int)exitdir];
 		int x2 = 2 * TileX(m_destTile);
 		int y2 = 2 * TileY(m_destTile);
+		if (m_intermediatePatch != INVALID_WATER_REGION_PATCH) {
+			/* Estimate the distance to the nearest point of the intermediate region instead */
+			x2 = Clamp(x1, 2 * TileX(m_intermediateArea.tile), 2 * (TileX(m_intermediateArea.tile) + m_intermediateArea.w - 1));
+			y2 = Clamp(y1, 2 * TileY(m_intermediateArea.tile), 2 * (TileY(m_intermediateArea.tile) + m_intermediateArea.h - 1));
+		}
 		int dx = abs(x1 - x2);
 		int dy = abs(y1 - y2);
 		int dmin = std::min(dx, dy);
@@ -125,7 +209,7 @@ public:
 	inline void PfFollowNode(Node &old_node)
 	{
 		TrackFollower F(Yapf().GetVehicle());
-		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td)) {
+		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td) && Yapf().IsTileInWaterRegionCorridor(F.m_new_tile)) {
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
@@ -137,6 +221,11 @@ public:
 	}
 
 	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache)
+	{
+		return ChooseShipTrack(v, tile, enterdir, tracks, path_found, path_cache, _settings_game.pf.yapf.ship_use_water_regions);
+	}
+
+	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache, bool use_water_regions)
 	{
 		/* handle special case - when next tile is destination tile */
 		if (tile == v->dest_tile) {
@@ -163,9 +252,13 @@ public:
 		/* set origin and destination nodes */
 		pf.SetOrigin(src_tile, trackdirs);
 		pf.SetDestination(v);
+		const bool restricted = use_water_regions && pf.SetWaterRegionCorridor(src_tile);
 		/* find best path */
 		path_found = pf.FindPath(v);
 
+		/* The corridor should always contain a path, but search the whole map if it does not */
+		if (restricted && !path_found) return ChooseShipTrack(v, tile, enterdir, tracks, path_found, path_cache, false);
+
 		Trackdir next_trackdir = INVALID_TRACKDIR; // this would mean "path not found"
 
 		Node *pNode = pf.GetBestNode();
@@ -351,6 +444,8 @@ struct CYapfShip2 : CYapfT<CYapfShip_TypesT<CYapfShip2, CFollowTrackWater    , C
 /** Ship controller helper - path finder invoker */
 Track YapfShipChooseTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache)
 {
+	ZONE_PROFILE("YapfShipChooseTrack");
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseShipTrack)(const Ship*, TileIndex, DiagDirection, TrackBits, bool &path_found, ShipPathCache &path_cache);
 	PfnChooseShipTrack pfnChooseShipTrack = CYapfShip2::ChooseShipTrack; // default: ExitDir
@@ -101,47 +101,54 @@ struct TrainReservationLookAhead {
 	std::deque<TrainReservationLookAheadCurve> curves;
 	int32 cached_zpos = 0;                ///< Cached z position as used in TrainDecelerationStats
 	uint8 zpos_refresh_remaining = 0;     ///< Remaining position updates before next refresh of cached_zpos
+	int16 items_min_z = INT16_MAX;        ///< Lower bound of the z position of all items, used to limit the look-ahead braking distance
 
 	int32 RealEndPosition() const
 	{
 		return this->reservation_end_position - (this->tunnel_bridge_reserved_tiles * TILE_SIZE);
 	}
 
+	void AddItem(const TrainReservationLookAheadItem &item)
+	{
+		this->items.push_back(item);
+		this->items_min_z = std::min(this->items_min_z, item.z_pos);
+	}
+
 	void AddStation(int tiles, StationID id, int16 z_pos)
 	{
 		int end = this->RealEndPosition();
-		this->items.push_back({ end, end + (((int)TILE_SIZE) * tiles), z_pos, id, 0, TRLIT_STATION });
+		this->AddItem({ end, end + (((int)TILE_SIZE) * tiles), z_pos, id, 0, TRLIT_STATION });
 	}
 
 	void AddReverse(int16 z_pos)
 	{
 		int end = this->RealEndPosition();
-		this->items.push_back({ end, end, z_pos, 0, 0, TRLIT_REVERSE });
+		this->AddItem({ end, end, z_pos, 0, 0, TRLIT_REVERSE });
 	}
 
 	void AddTrackSpeedLimit(uint16 speed, int offset, int duration, int16 z_pos)
 	{
 		int end = this->RealEndPosition();
-		this->items.push_back({ end + offset, end + offset + duration, z_pos, speed, 0, TRLIT_TRACK_SPEED });
+		this->AddItem({ end + offset, end + offset + duration, z_pos, speed, 0, TRLIT_TRACK_SPEED });
 	}
 
 	void AddSpeedRestriction(uint16 speed, int offset, int duration, int16 z_pos)
 	{
 		int end = this->RealEndPosition();
-		this->items.push_back({ end + offset, end + offset + duration, z_pos, speed, 0, TRLIT_SPEED_RESTRICTION });
+		this->AddItem({ end + offset, end + offset + duration, z_pos, speed, 0, TRLIT_SPEED_RESTRICTION });
 		this->speed_restriction = speed;
 	}
 
 	void AddSignal(uint16 target_speed, int offset, int16 z_pos, uint16 flags)
 	{
 		int end = this->RealEndPosition();
-		this->items.push_back({ end + offset, end + offset, z_pos, target_speed, flags, TRLIT_SIGNAL });
+		this->AddItem({ end + offset, end + offset, z_pos, target_speed, flags, TRLIT_SIGNAL });
 	}
 
 	void AddCurveSpeedLimit(uint16 target_speed, int offset, int16 z_pos)
 	{
 		int end = this->RealEndPosition();
-		this->items.push_back({ end + offset, end + offset, z_pos, target_speed, 0, TRLIT_CURVE_SPEED });
+		this->AddItem({ end + offset, end + offset, z_pos, target_speed, 0, TRLIT_CURVE_SPEED });
 	}
 
 	void SetNextExtendPosition();
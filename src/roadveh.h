@@ -82,6 +82,9 @@ static const byte RV_OVERTAKE_TIMEOUT = 35;
 void RoadVehUpdateCache(RoadVehicle *v, bool same_length = false);
 void GetRoadVehSpriteSize(EngineID engine, uint &width, uint &height, int &xoffs, int &yoffs, EngineImageType image_type);
 
+extern uint64 _rv_shared_path_cache_hits;
+extern uint64 _rv_shared_path_cache_misses;
+
 struct RoadVehPathCache {
 	std::deque<Trackdir> td;
 	std::deque<TileIndex> tile;
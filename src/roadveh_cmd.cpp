@@ -25,6 +25,7 @@
 #include "ai/ai.hpp"
 #include "game/game.hpp"
 #include "depot_map.h"
+#include "depot_func.h"
 #include "effectvehicle_func.h"
 #include "roadstop_base.h"
 #include "spritecache.h"
@@ -42,6 +43,8 @@
 
 #include "table/strings.h"
 
+#include <algorithm>
+
 #include "safeguards.h"
 
 static const uint16 _roadveh_images[] = {
@@ -356,7 +359,14 @@ static FindDepotData FindClosestRoadDepot(const RoadVehicle *v, int max_distance
 
 	switch (_settings_game.pf.pathfinder_for_roadvehs) {
 		case VPF_NPF: return NPFRoadVehicleFindNearestDepot(v, max_distance);
-		case VPF_YAPF: return YapfRoadVehicleFindNearestDepot(v, max_distance);
+		case VPF_YAPF:
+			if (max_distance > 0) {
+				/* Each tile travelled costs at least YAPF_TILE_LENGTH, or YAPF_TILE_CORNER_LENGTH plus the curve penalty for curved road,
+				 * so don't bother searching when there are no depots close enough. */
+				const int min_tile_cost = std::min<int>(YAPF_TILE_LENGTH, YAPF_TILE_CORNER_LENGTH + _settings_game.pf.yapf.road_curve_penalty);
+				if (FindNearestDepotWithinManhattanDistance(VEH_ROAD, v->owner, v->tile, max_distance / min_tile_cost) == nullptr) return FindDepotData();
+			}
+			return YapfRoadVehicleFindNearestDepot(v, max_distance);
 
 		default: NOT_REACHED();
 	}
@@ -1152,6 +1162,52 @@ static int PickRandomBit(uint bits)
 	return i;
 }
 
+uint64 _rv_shared_path_cache_hits = 0;   ///< Number of road vehicle paths taken from the path cache of another vehicle
+uint64 _rv_shared_path_cache_misses = 0; ///< Number of failed attempts to take a path from the path cache of another vehicle
+
+/**
+ * Try to take the path for a choice tile from the path cache of another vehicle sharing orders with this one,
+ * which is heading to the same destination with the same pathfinder inputs.
+ * The path caches of all vehicles are saved, so this does not depend on any state which a joining client would not have.
+ * @param v The vehicle, whose path cache must be empty.
+ * @param tile The choice tile which the vehicle is about to enter.
+ * @param trackdirs The trackdirs which the vehicle can choose from on tile.
+ * @return The trackdir to take on tile, or INVALID_TRACKDIR if no other vehicle has a usable path.
+ */
+static Trackdir FindSharedRoadVehPath(RoadVehicle *v, TileIndex tile, TrackdirBits trackdirs)
+{
+	if (!v->IsOrderListShared() || tile == v->dest_tile) return INVALID_TRACKDIR;
+
+	const Order &order = v->current_order;
+	const bool is_bus = v->IsBus();
+	const bool articulated = v->HasArticulatedPart();
+	for (const Vehicle *shared = v->FirstShared(); shared != nullptr; shared = shared->NextShared()) {
+		if (shared == v) continue;
+		const RoadVehicle *u = RoadVehicle::From(shared);
+		if (u->path.empty() || u->path.layout_ctr != _road_layout_change_counter) continue;
+		if (u->dest_tile != v->dest_tile || u->roadtype != v->roadtype || u->compatible_roadtypes != v->compatible_roadtypes) continue;
+		if (u->current_order.GetType() != order.GetType() || u->current_order.GetDestination() != order.GetDestination()) continue;
+		if (u->current_order.GetRoadVehTravelDirection() != order.GetRoadVehTravelDirection() || u->current_order.GetMaxSpeed() != order.GetMaxSpeed()) continue;
+		if (u->GetDisplayMaxSpeed() != v->GetDisplayMaxSpeed() || u->IsBus() != is_bus || u->HasArticulatedPart() != articulated) continue;
+
+		auto iter = std::find(u->path.tile.begin(), u->path.tile.end(), tile);
+		if (iter == u->path.tile.end()) continue;
+
+		size_t offset = iter - u->path.tile.begin();
+		Trackdir trackdir = u->path.td[offset];
+		if (!HasBit(trackdirs, trackdir)) continue;
+
+		v->path.tile.assign(iter + 1, u->path.tile.end());
+		v->path.td.assign(u->path.td.begin() + offset + 1, u->path.td.end());
+		v->path.layout_ctr = _road_layout_change_counter;
+		_rv_shared_path_cache_hits++;
+		return trackdir;
+	}
+
+	_rv_shared_path_cache_misses++;
+	return INVALID_TRACKDIR;
+}
+
 /**
  * Returns direction to for a road vehicle to take or
  * INVALID_TRACKDIR if the direction is currently blocked
@@ -1271,11 +1327,16 @@ static Trackdir RoadFindPathToDest(RoadVehicle *v, TileIndex tile, DiagDirection
 		}
 	}
 
-	switch (_settings_game.pf.pathfinder_for_roadvehs) {
-		case VPF_NPF:  best_track = NPFRoadVehicleChooseTrack(v, tile, enterdir, path_found); break;
-		case VPF_YAPF: best_track = YapfRoadVehicleChooseTrack(v, tile, enterdir, trackdirs, path_found, v->path); break;
+	/* Attempt to follow the cached path of another vehicle on the same route. */
+	best_track = (_settings_game.pf.pathfinder_for_roadvehs == VPF_YAPF) ? FindSharedRoadVehPath(v, tile, trackdirs) : INVALID_TRACKDIR;
 
-		default: NOT_REACHED();
+	if (best_track == INVALID_TRACKDIR) {
+		switch (_settings_game.pf.pathfinder_for_roadvehs) {
+			case VPF_NPF:  best_track = NPFRoadVehicleChooseTrack(v, tile, enterdir, path_found); break;
+			case VPF_YAPF: best_track = YapfRoadVehicleChooseTrack(v, tile, enterdir, trackdirs, path_found, v->path); break;
+
+			default: NOT_REACHED();
+		}
 	}
 	DEBUG_UPDATESTATECHECKSUM("RoadFindPathToDest: v: %u, path_found: %d, best_track: %d", v->index, path_found, best_track);
 	UpdateStateChecksum((((uint64) v->index) << 32) | (path_found << 16) | best_track);
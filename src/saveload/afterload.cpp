@@ -4020,6 +4020,8 @@ bool AfterLoadGame()
 
 	if (SlXvIsFeatureMissing(XSLFI_ANIMATED_TILE_EXTRA)) {
 		UpdateAllAnimatedTileSpeeds();
+	} else {
+		RebuildAnimatedTileBuckets();
 	}
 
 	if (!SlXvIsFeaturePresent(XSLFI_REALISTIC_TRAIN_BRAKING, 2)) {
@@ -4335,6 +4337,8 @@ void ReloadNewGRFData()
 	GroupStatistics::UpdateAfterLoad();
 	/* update station graphics */
 	AfterLoadStations();
+	/* house and industry tile acceptance may have changed */
+	for (Station *st : Station::Iterate()) st->catchment_acceptance_valid = false;
 
 	RailType rail_type_translate_map[RAILTYPE_END];
 	for (RailType old_type = RAILTYPE_BEGIN; old_type != RAILTYPE_END; old_type++) {
@@ -13,16 +13,61 @@
 #include "../../debug.h"
 #include "../../script/squirrel.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #include "../../safeguards.h"
 
 /**
  * Base class for any ScriptList sorter.
+ * The list is stored in b-trees, of which any modification invalidates all iterators.
+ * Sorters therefore keep the key of the next item, and look it up again if the list
+ * was changed since the iterator was last positioned.
  */
 class ScriptListSorter {
 protected:
 	ScriptList *list;       ///< The list that's being sorted.
 	bool has_no_more_items; ///< Whether we have more items to iterate over.
+	bool iter_at_end;       ///< Whether the iterator has moved past the last item.
 	SQInteger item_next;    ///< The next item we will show.
+	int iter_modifications; ///< The modification count of the list when the iterator was last positioned.
+
+	/**
+	 * Build the values index of the list, if necessary.
+	 */
+	void InitListValues()
+	{
+		this->list->InitValues();
+	}
+
+	/**
+	 * Whether the iterator can still be used, or has to be looked up again using the key of the next item.
+	 */
+	bool IsIterValid() const
+	{
+		return this->iter_modifications == this->list->modifications;
+	}
+
+	/**
+	 * Mark the iterator as valid for the current state of the list.
+	 */
+	void SetIterValid()
+	{
+		this->iter_modifications = this->list->modifications;
+	}
+
+	/**
+	 * Mark the iterator as invalid, it will be looked up again before it is next used.
+	 */
+	void SetIterInvalid()
+	{
+		this->iter_modifications = this->list->modifications - 1;
+	}
+
+	/**
+	 * Find the next item, and store that information.
+	 */
+	virtual void FindNext() = 0;
 
 public:
 	/**
@@ -38,35 +83,56 @@ public:
 	/**
 	 * Stop iterating a sorter.
 	 */
-	virtual void End() = 0;
+	void End()
+	{
+		this->has_no_more_items = true;
+		this->iter_at_end = true;
+		this->item_next = 0;
+	}
 
 	/**
 	 * Get the next item of the sorter.
 	 */
-	virtual SQInteger Next() = 0;
+	SQInteger Next()
+	{
+		if (this->IsEnd()) return 0;
+
+		SQInteger item_current = this->item_next;
+		this->FindNext();
+		return item_current;
+	}
 
 	/**
 	 * See if the sorter has reached the end.
 	 */
 	bool IsEnd()
 	{
-		return this->list->buckets.empty() || this->has_no_more_items;
+		return this->list->items.empty() || this->has_no_more_items;
 	}
 
 	/**
-	 * Callback from the list if an item gets removed.
+	 * Callback from the list if an item gets removed, or its value gets changed.
 	 */
-	virtual void Remove(SQInteger item) = 0;
+	void Remove(SQInteger item)
+	{
+		if (this->IsEnd()) return;
+
+		/* If we remove the 'next' item, skip to the next */
+		if (item == this->item_next) this->FindNext();
+
+		/* The item is about to be removed from the b-trees, which invalidates the iterator */
+		this->SetIterInvalid();
+	}
 
 	/**
 	 * Attach the sorter to a new list. This assumes the content of the old list has been moved to
-	 * the new list, too, so that we don't have to invalidate any iterators. Note that std::swap
-	 * doesn't invalidate iterators on lists and maps, so that should be safe.
+	 * the new list, too. The iterator is looked up again in the new list when it is next used.
 	 * @param target New list to attach to.
 	 */
-	virtual void Retarget(ScriptList *new_list)
+	void Retarget(ScriptList *new_list)
 	{
 		this->list = new_list;
+		this->SetIterInvalid();
 	}
 };
 
@@ -75,9 +141,8 @@ public:
  */
 class ScriptListSorterValueAscending : public ScriptListSorter {
 private:
-	ScriptList::ScriptListBucket::iterator bucket_iter;    ///< The iterator over the list to find the buckets.
-	ScriptList::ScriptItemList *bucket_list;               ///< The current bucket list we're iterator over.
-	ScriptList::ScriptItemList::iterator bucket_list_iter; ///< The iterator over the bucket list.
+	ScriptList::ScriptListValueSet::iterator value_iter; ///< The iterator over the (value, item) pairs.
+	SQInteger value_next;                                ///< The value of the next item we will show.
 
 public:
 	/**
@@ -92,67 +157,42 @@ public:
 
 	SQInteger Begin()
 	{
-		if (this->list->buckets.empty()) return 0;
+		if (this->list->items.empty()) return 0;
+		this->InitListValues();
 		this->has_no_more_items = false;
+		this->iter_at_end = false;
 
-		this->bucket_iter = this->list->buckets.begin();
-		this->bucket_list = &(*this->bucket_iter).second;
-		this->bucket_list_iter = this->bucket_list->begin();
-		this->item_next = *this->bucket_list_iter;
+		this->value_iter = this->list->values.begin();
+		this->value_next = this->value_iter->first;
+		this->item_next = this->value_iter->second;
+		this->SetIterValid();
 
 		SQInteger item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->bucket_list = nullptr;
-		this->has_no_more_items = true;
-		this->item_next = 0;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->bucket_list == nullptr) {
+		if (this->iter_at_end) {
 			this->has_no_more_items = true;
 			return;
 		}
 
-		this->bucket_list_iter++;
-		if (this->bucket_list_iter == this->bucket_list->end()) {
-			this->bucket_iter++;
-			if (this->bucket_iter == this->list->buckets.end()) {
-				this->bucket_list = nullptr;
-				return;
-			}
-			this->bucket_list = &(*this->bucket_iter).second;
-			this->bucket_list_iter = this->bucket_list->begin();
+		if (this->IsIterValid()) {
+			++this->value_iter;
+		} else {
+			this->InitListValues();
+			this->value_iter = this->list->values.upper_bound(std::make_pair(this->value_next, this->item_next));
 		}
-		this->item_next = *this->bucket_list_iter;
-	}
-
-	SQInteger Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
-
-	void Remove(SQInteger item)
-	{
-		if (this->IsEnd()) return;
+		this->SetIterValid();
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		if (this->value_iter == this->list->values.end()) {
+			this->iter_at_end = true;
 			return;
 		}
+		this->value_next = this->value_iter->first;
+		this->item_next = this->value_iter->second;
 	}
 };
 
@@ -161,12 +201,8 @@ public:
  */
 class ScriptListSorterValueDescending : public ScriptListSorter {
 private:
-	/* Note: We cannot use reverse_iterator.
-	 *       The iterators must only be invalidated when the element they are pointing to is removed.
-	 *       This only holds for forward iterators. */
-	ScriptList::ScriptListBucket::iterator bucket_iter;    ///< The iterator over the list to find the buckets.
-	ScriptList::ScriptItemList *bucket_list;               ///< The current bucket list we're iterator over.
-	ScriptList::ScriptItemList::iterator bucket_list_iter; ///< The iterator over the bucket list.
+	ScriptList::ScriptListValueSet::iterator value_iter; ///< The iterator over the (value, item) pairs.
+	SQInteger value_next;                                ///< The value of the next item we will show.
 
 public:
 	/**
@@ -181,75 +217,44 @@ public:
 
 	SQInteger Begin()
 	{
-		if (this->list->buckets.empty()) return 0;
+		if (this->list->items.empty()) return 0;
+		this->InitListValues();
 		this->has_no_more_items = false;
+		this->iter_at_end = false;
 
-		/* Go to the end of the bucket-list */
-		this->bucket_iter = this->list->buckets.end();
-		--this->bucket_iter;
-		this->bucket_list = &(*this->bucket_iter).second;
-
-		/* Go to the end of the items in the bucket */
-		this->bucket_list_iter = this->bucket_list->end();
-		--this->bucket_list_iter;
-		this->item_next = *this->bucket_list_iter;
+		/* Go to the end of the list */
+		this->value_iter = this->list->values.end();
+		--this->value_iter;
+		this->value_next = this->value_iter->first;
+		this->item_next = this->value_iter->second;
+		this->SetIterValid();
 
 		SQInteger item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->bucket_list = nullptr;
-		this->has_no_more_items = true;
-		this->item_next = 0;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->bucket_list == nullptr) {
+		if (this->iter_at_end) {
 			this->has_no_more_items = true;
 			return;
 		}
 
-		if (this->bucket_list_iter == this->bucket_list->begin()) {
-			if (this->bucket_iter == this->list->buckets.begin()) {
-				this->bucket_list = nullptr;
-				return;
-			}
-			this->bucket_iter--;
-			this->bucket_list = &(*this->bucket_iter).second;
-			/* Go to the end of the items in the bucket */
-			this->bucket_list_iter = this->bucket_list->end();
-			--this->bucket_list_iter;
-		} else {
-			this->bucket_list_iter--;
+		if (!this->IsIterValid()) {
+			/* Find the first pair not before the next item, the item before that is the one we want */
+			this->InitListValues();
+			this->value_iter = this->list->values.lower_bound(std::make_pair(this->value_next, this->item_next));
 		}
-		this->item_next = *this->bucket_list_iter;
-	}
-
-	SQInteger Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
-
-	void Remove(SQInteger item)
-	{
-		if (this->IsEnd()) return;
+		this->SetIterValid();
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		if (this->value_iter == this->list->values.begin()) {
+			this->iter_at_end = true;
 			return;
 		}
+		--this->value_iter;
+		this->value_next = this->value_iter->first;
+		this->item_next = this->value_iter->second;
 	}
 };
 
@@ -275,51 +280,36 @@ public:
 	{
 		if (this->list->items.empty()) return 0;
 		this->has_no_more_items = false;
+		this->iter_at_end = false;
 
 		this->item_iter = this->list->items.begin();
-		this->item_next = (*this->item_iter).first;
+		this->item_next = this->item_iter->first;
+		this->SetIterValid();
 
 		SQInteger item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->has_no_more_items = true;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->item_iter == this->list->items.end()) {
+		if (this->iter_at_end) {
 			this->has_no_more_items = true;
 			return;
 		}
-		this->item_iter++;
-		if (this->item_iter != this->list->items.end()) item_next = (*this->item_iter).first;
-	}
-
-	SQInteger Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
 
-	void Remove(SQInteger item)
-	{
-		if (this->IsEnd()) return;
+		if (this->IsIterValid()) {
+			++this->item_iter;
+		} else {
+			this->item_iter = this->list->items.upper_bound(this->item_next);
+		}
+		this->SetIterValid();
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		if (this->item_iter == this->list->items.end()) {
+			this->iter_at_end = true;
 			return;
 		}
+		this->item_next = this->item_iter->first;
 	}
 };
 
@@ -328,9 +318,6 @@ public:
  */
 class ScriptListSorterItemDescending : public ScriptListSorter {
 private:
-	/* Note: We cannot use reverse_iterator.
-	 *       The iterators must only be invalidated when the element they are pointing to is removed.
-	 *       This only holds for forward iterators. */
 	ScriptList::ScriptListMap::iterator item_iter; ///< The iterator over the items in the map.
 
 public:
@@ -348,57 +335,37 @@ public:
 	{
 		if (this->list->items.empty()) return 0;
 		this->has_no_more_items = false;
+		this->iter_at_end = false;
 
 		this->item_iter = this->list->items.end();
 		--this->item_iter;
-		this->item_next = (*this->item_iter).first;
+		this->item_next = this->item_iter->first;
+		this->SetIterValid();
 
 		SQInteger item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->has_no_more_items = true;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->item_iter == this->list->items.end()) {
+		if (this->iter_at_end) {
 			this->has_no_more_items = true;
 			return;
 		}
-		if (this->item_iter == this->list->items.begin()) {
-			/* Use 'end' as marker for 'beyond begin' */
-			this->item_iter = this->list->items.end();
-		} else {
-			this->item_iter--;
-		}
-		if (this->item_iter != this->list->items.end()) item_next = (*this->item_iter).first;
-	}
 
-	SQInteger Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
-
-	void Remove(SQInteger item)
-	{
-		if (this->IsEnd()) return;
+		if (!this->IsIterValid()) {
+			/* Find the first item not before the next item, the item before that is the one we want */
+			this->item_iter = this->list->items.lower_bound(this->item_next);
+		}
+		this->SetIterValid();
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		if (this->item_iter == this->list->items.begin()) {
+			this->iter_at_end = true;
 			return;
 		}
+		--this->item_iter;
+		this->item_next = this->item_iter->first;
 	}
 };
 
@@ -412,6 +379,7 @@ ScriptList::ScriptList()
 	this->sort_ascending = false;
 	this->initialized    = false;
 	this->modifications  = 0;
+	this->values_inited  = false;
 }
 
 ScriptList::~ScriptList()
@@ -429,18 +397,59 @@ void ScriptList::Clear()
 	this->modifications++;
 
 	this->items.clear();
-	this->buckets.clear();
+	this->values.clear();
+	this->values_inited = false;
 	this->sorter->End();
 }
 
+/**
+ * Build the index of the items sorted by value, if it is not currently valid.
+ * The index is only needed when sorting by value, and is dropped when valuating,
+ * as bulk building it is cheaper than updating it for every item.
+ */
+void ScriptList::InitValues()
+{
+	if (this->values_inited) return;
+
+	std::vector<std::pair<SQInteger, SQInteger>> sorted;
+	sorted.reserve(this->items.size());
+	for (const auto &it : this->items) {
+		sorted.emplace_back(it.second, it.first);
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	this->values.clear();
+	for (const auto &it : sorted) {
+		this->values.insert(this->values.end(), it);
+	}
+	this->values_inited = true;
+}
+
+/**
+ * Remove all items for which the predicate returns true.
+ * @param proc Predicate, called with the value of each item.
+ */
+template <typename F>
+void ScriptList::RemoveItems(F proc)
+{
+	for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end();) {
+		if (proc(iter->second)) {
+			this->sorter->Remove(iter->first);
+			if (this->values_inited) this->values.erase(std::make_pair(iter->second, iter->first));
+			iter = this->items.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
 void ScriptList::AddItem(SQInteger item, SQInteger value)
 {
 	this->modifications++;
 
-	if (this->HasItem(item)) return;
+	if (!this->items.insert(std::make_pair(item, value)).second) return;
 
-	this->items[item] = value;
-	this->buckets[value].insert(item);
+	if (this->values_inited) this->values.insert(std::make_pair(value, item));
 }
 
 void ScriptList::RemoveItem(SQInteger item)
@@ -450,13 +459,8 @@ void ScriptList::RemoveItem(SQInteger item)
 	ScriptListMap::iterator item_iter = this->items.find(item);
 	if (item_iter == this->items.end()) return;
 
-	SQInteger value = item_iter->second;
-
 	this->sorter->Remove(item);
-	ScriptListBucket::iterator bucket_iter = this->buckets.find(value);
-	assert(bucket_iter != this->buckets.end());
-	bucket_iter->second.erase(item);
-	if (bucket_iter->second.empty()) this->buckets.erase(bucket_iter);
+	if (this->values_inited) this->values.erase(std::make_pair(item_iter->second, item));
 	this->items.erase(item_iter);
 }
 
@@ -511,12 +515,11 @@ bool ScriptList::SetValue(SQInteger item, SQInteger value)
 	if (value_old == value) return true;
 
 	this->sorter->Remove(item);
-	ScriptListBucket::iterator bucket_iter = this->buckets.find(value_old);
-	assert(bucket_iter != this->buckets.end());
-	bucket_iter->second.erase(item);
-	if (bucket_iter->second.empty()) this->buckets.erase(bucket_iter);
+	if (this->values_inited) {
+		this->values.erase(std::make_pair(value_old, item));
+		this->values.insert(std::make_pair(value, item));
+	}
 	item_iter->second = value;
-	this->buckets[value].insert(item);
 
 	return true;
 }
@@ -560,7 +563,8 @@ void ScriptList::AddList(ScriptList *list)
 	if (this->IsEmpty()) {
 		/* If this is empty, we can just take the items of the other list as is. */
 		this->items = list->items;
-		this->buckets = list->buckets;
+		this->values = list->values;
+		this->values_inited = list->values_inited;
 		this->modifications++;
 	} else {
 		ScriptListMap *list_items = &list->items;
@@ -576,7 +580,8 @@ void ScriptList::SwapList(ScriptList *list)
 	if (list == this) return;
 
 	this->items.swap(list->items);
-	this->buckets.swap(list->buckets);
+	this->values.swap(list->values);
+	Swap(this->values_inited, list->values_inited);
 	Swap(this->sorter, list->sorter);
 	Swap(this->sorter_type, list->sorter_type);
 	Swap(this->sort_ascending, list->sort_ascending);
@@ -590,40 +595,28 @@ void ScriptList::RemoveAboveValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([value](SQInteger v) { return v > value; });
 }
 
 void ScriptList::RemoveBelowValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second < value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([value](SQInteger v) { return v < value; });
 }
 
 void ScriptList::RemoveBetweenValue(SQInteger start, SQInteger end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > start && (*iter).second < end) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([start, end](SQInteger v) { return v > start && v < end; });
 }
 
 void ScriptList::RemoveValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second == value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([value](SQInteger v) { return v == value; });
 }
 
 void ScriptList::RemoveTop(SQInteger count)
@@ -640,17 +633,10 @@ void ScriptList::RemoveTop(SQInteger count)
 	switch (this->sorter_type) {
 		default: NOT_REACHED();
 		case SORT_BY_VALUE:
-			for (ScriptListBucket::iterator iter = this->buckets.begin(); iter != this->buckets.end(); iter = this->buckets.begin()) {
-				ScriptItemList *items = &(*iter).second;
-				size_t size = items->size();
-				for (ScriptItemList::iterator iter = items->begin(); iter != items->end(); iter = items->begin()) {
-					if (--count < 0) return;
-					this->RemoveItem(*iter);
-					/* When the last item is removed from the bucket, the bucket itself is removed.
-					 * This means that the iterators can be invalid after a call to RemoveItem.
-					 */
-					if (--size == 0) break;
-				}
+			this->InitValues();
+			for (ScriptListValueSet::iterator iter = this->values.begin(); iter != this->values.end(); iter = this->values.begin()) {
+				if (--count < 0) return;
+				this->RemoveItem((*iter).second);
 			}
 			break;
 
@@ -677,17 +663,10 @@ void ScriptList::RemoveBottom(SQInteger count)
 	switch (this->sorter_type) {
 		default: NOT_REACHED();
 		case SORT_BY_VALUE:
-			for (ScriptListBucket::reverse_iterator iter = this->buckets.rbegin(); iter != this->buckets.rend(); iter = this->buckets.rbegin()) {
-				ScriptItemList *items = &(*iter).second;
-				size_t size = items->size();
-				for (ScriptItemList::reverse_iterator iter = items->rbegin(); iter != items->rend(); iter = items->rbegin()) {
-					if (--count < 0) return;
-					this->RemoveItem(*iter);
-					/* When the last item is removed from the bucket, the bucket itself is removed.
-					 * This means that the iterators can be invalid after a call to RemoveItem.
-					 */
-					if (--size == 0) break;
-				}
+			this->InitValues();
+			for (ScriptListValueSet::reverse_iterator iter = this->values.rbegin(); iter != this->values.rend(); iter = this->values.rbegin()) {
+				if (--count < 0) return;
+				this->RemoveItem((*iter).second);
 			}
 			break;
 
@@ -718,40 +697,28 @@ void ScriptList::KeepAboveValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([value](SQInteger v) { return v <= value; });
 }
 
 void ScriptList::KeepBelowValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second >= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([value](SQInteger v) { return v >= value; });
 }
 
 void ScriptList::KeepBetweenValue(SQInteger start, SQInteger end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= start || (*iter).second >= end) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([start, end](SQInteger v) { return v <= start || v >= end; });
 }
 
 void ScriptList::KeepValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second != value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems([value](SQInteger v) { return v != value; });
 }
 
 void ScriptList::KeepTop(SQInteger count)
@@ -866,6 +833,13 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 	bool backup_allow = ScriptObject::GetAllowDoCommand();
 	ScriptObject::SetAllowDoCommand(false);
 
+	/* Updating the values index for every item is more expensive than rebuilding it when it is next needed.
+	 * It must be kept if an iteration by value is in progress, as that relies on it. */
+	if (this->sorter_type != SORT_BY_VALUE || this->sorter->IsEnd()) {
+		this->values.clear();
+		this->values_inited = false;
+	}
+
 	/* Push the function to call */
 	sq_push(vm, 2);
 
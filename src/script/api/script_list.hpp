@@ -12,8 +12,8 @@
 #define SCRIPT_LIST_HPP
 
 #include "script_object.hpp"
-#include <map>
-#include <set>
+#include "../../3rdparty/cpp-btree/btree_map.h"
+#include "../../3rdparty/cpp-btree/btree_set.h"
 
 class ScriptListSorter;
 
@@ -40,14 +40,19 @@ private:
 	bool sort_ascending;          ///< Whether to sort ascending or descending
 	bool initialized;             ///< Whether an iteration has been started
 	int modifications;            ///< Number of modification that has been done. To prevent changing data while valuating.
+	bool values_inited;           ///< Whether the values index is valid, it is built on demand
+
+	friend class ScriptListSorter;
+
+	void InitValues();
+	template <typename F> void RemoveItems(F proc);
 
 public:
-	typedef std::set<SQInteger> ScriptItemList;                   ///< The list of items inside the bucket
-	typedef std::map<SQInteger, ScriptItemList> ScriptListBucket; ///< The bucket list per value
-	typedef std::map<SQInteger, SQInteger> ScriptListMap;         ///< List per item
+	typedef btree::btree_map<SQInteger, SQInteger> ScriptListMap;                    ///< List per item
+	typedef btree::btree_set<std::pair<SQInteger, SQInteger>> ScriptListValueSet;    ///< List of value/item pairs
 
 	ScriptListMap items;           ///< The items in the list
-	ScriptListBucket buckets;      ///< The items in the list, sorted by value
+	ScriptListValueSet values;     ///< The items in the list, sorted by value, only valid if values_inited is set
 
 	ScriptList();
 	~ScriptList();
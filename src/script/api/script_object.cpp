@@ -19,10 +19,12 @@
 #include "../../strings_func.h"
 #include "../../scope_info.h"
 #include "../../map_func.h"
+#include "../../core/random_func.hpp"
 
 #include "../script_storage.hpp"
 #include "../script_instance.hpp"
 #include "../script_fatalerror.hpp"
+#include "../script_parallel.hpp"
 #include "script_controller.hpp"
 #include "script_error.hpp"
 #include "../../debug.h"
@@ -39,7 +41,7 @@ static ScriptStorage *GetStorage()
 }
 
 
-/* static */ ScriptInstance *ScriptObject::ActiveInstance::active = nullptr;
+/* static */ thread_local ScriptInstance *ScriptObject::ActiveInstance::active = nullptr;
 
 ScriptObject::ActiveInstance::ActiveInstance(ScriptInstance *instance) : alc_scope(instance->engine)
 {
@@ -365,6 +367,27 @@ ScriptObject::ActiveInstance::~ActiveInstance()
 	SCOPE_INFO_FMT([=], "ScriptObject::DoCommand: tile: %X (%d x %d), p1: 0x%X, p2: 0x%X, p3: 0x" OTTD_PRINTFHEX64 ", company: %s, cmd: 0x%X (%s), estimate_only: %d",
 			tile, TileX(tile), TileY(tile), p1, p2, p3, scope_dumper().CompanyInfo(_current_company), cmd, GetCommandName(cmd), estimate_only);
 
+	if (_script_parallel_active && !estimate_only) {
+		/* Scripts are being run in parallel, only test the command now.
+		 * It is executed once all scripts have been run, in company order, see DoDeferredCommand.
+		 * The order in which scripts test their commands is not deterministic, so the test is not
+		 * recorded in the command log, and any change to the random seeds is undone. */
+		SavedRandomSeeds saved_seeds;
+		SaveRandomSeeds(&saved_seeds);
+		CommandCost res = ::DoCommandPInternal(tile, p1, p2, p3, cmd, nullptr, text, false, true, aux_data);
+		RestoreRandomSeeds(saved_seeds);
+		if (res.Failed()) {
+			SetLastError(ScriptError::StringToError(res.GetErrorMessage()));
+			return false;
+		}
+
+		/* No error, then clear it. */
+		SetLastError(ScriptError::ERR_NONE);
+
+		GetActiveInstance()->deferred_command = CommandContainer{ tile, p1, p2, cmd, p3, nullptr, text != nullptr ? text : "", CommandAuxiliaryPtr(aux_data != nullptr ? aux_data->Clone() : nullptr) };
+		throw Script_Suspend(_networking ? -(int)GetDoCommandDelay() : GetDoCommandDelay(), callback);
+	}
+
 	/* Store the command for command callback validation. */
 	if (!estimate_only && _networking && !_generating_world) SetLastCommand(tile, p1, p2, p3, cmd);
 
@@ -425,6 +448,43 @@ ScriptObject::ActiveInstance::~ActiveInstance()
 	NOT_REACHED();
 }
 
+/* static */ void ScriptObject::DoDeferredCommand(const CommandContainer &cmd)
+{
+	SCOPE_INFO_FMT([&], "ScriptObject::DoDeferredCommand: tile: %X (%d x %d), p1: 0x%X, p2: 0x%X, p3: 0x" OTTD_PRINTFHEX64 ", company: %s, cmd: 0x%X (%s)",
+			cmd.tile, TileX(cmd.tile), TileY(cmd.tile), cmd.p1, cmd.p2, cmd.p3, scope_dumper().CompanyInfo(_current_company), cmd.cmd, GetCommandName(cmd.cmd));
+
+	/* Store the command for command callback validation. */
+	if (_networking) SetLastCommand(cmd.tile, cmd.p1, cmd.p2, cmd.p3, cmd.cmd);
+
+	CommandCost res = ::DoCommandPScript(cmd.tile, cmd.p1, cmd.p2, cmd.p3, cmd.cmd,
+			_networking ? ScriptObject::GetActiveInstance()->GetDoCommandCallback() : nullptr,
+			cmd.text.c_str(), false, false, false, cmd.aux_data.get());
+
+	if (res.Failed()) {
+		/* The command passed its test when the script was run, but a command
+		 * of an earlier company in this tick has since made it fail. */
+		SetLastError(ScriptError::StringToError(res.GetErrorMessage()));
+		SetLastCommandRes(false);
+		if (_networking) {
+			/* The command was not sent, so there will be no callback to continue the script. */
+			SetLastCommand(INVALID_TILE, 0, 0, 0, CMD_END);
+			GetActiveInstance()->Continue();
+		}
+		return;
+	}
+
+	/* No error, then clear it. */
+	SetLastError(ScriptError::ERR_NONE);
+
+	/* In network games the result is handled by the command callback */
+	if (_networking) return;
+
+	IncreaseDoCommandCosts(res.GetCost());
+	SetLastCost(res.GetCost());
+	SetLastCommandResultData(res.GetResultData());
+	SetLastCommandRes(true);
+}
+
 
 /* static */ Randomizer ScriptObject::random_states[OWNER_END];
 
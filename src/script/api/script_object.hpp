@@ -44,6 +44,7 @@ typedef bool (ScriptAsyncModeProc)();
 class ScriptObject : public SimpleCountedObject {
 friend class ScriptInstance;
 friend class ScriptController;
+friend void ScriptParallelApiLock();
 protected:
 	/**
 	 * A class that handles the current active instance. By instantiating it at
@@ -60,7 +61,7 @@ protected:
 		ScriptInstance *last_active;    ///< The active instance before we go instantiated.
 		ScriptAllocatorScope alc_scope; ///< Keep the correct allocator for the script instance activated
 
-		static ScriptInstance *active;  ///< The global current active instance.
+		static thread_local ScriptInstance *active; ///< The current active instance of this thread.
 	};
 
 public:
@@ -109,6 +110,11 @@ protected:
 		return ScriptObject::DoCommandEx(tile, p1, p2, 0, cmd, text.c_str(), nullptr, callback);
 	}
 
+	/**
+	 * Execute a DoCommand of the script which was deferred whilst scripts were run in parallel.
+	 */
+	static void DoDeferredCommand(const struct CommandContainer &cmd);
+
 	/**
 	 * Store the latest command executed by the script.
 	 */
@@ -886,6 +886,19 @@ struct ScriptDebugWindow : public Window {
 		this->last_vscroll_pos = this->vscroll->GetPosition();
 	}
 
+	/**
+	 * Switch the name string to the variant which includes the memory usage of the script, if it is running.
+	 * @param instance Script instance, may be nullptr.
+	 */
+	void SetMemoryStringParameters(const ScriptInstance *instance) const
+	{
+		if (instance == nullptr) return;
+
+		SetDParam(0, STR_AI_DEBUG_NAME_AND_VERSION_MEMORY);
+		SetDParam(3, instance->GetAllocatedMemory());
+		SetDParam(4, instance->GetReservedMemory());
+	}
+
 	void SetStringParameters(int widget) const override
 	{
 		if (widget != WID_SCRD_NAME_TEXT) return;
@@ -896,6 +909,7 @@ struct ScriptDebugWindow : public Window {
 			SetDParam(0, STR_AI_DEBUG_NAME_AND_VERSION);
 			SetDParamStr(1, info->GetName());
 			SetDParam(2, info->GetVersion());
+			this->SetMemoryStringParameters(Game::GetInstance());
 		} else if (script_debug_company == INVALID_COMPANY || !Company::IsValidAiID(script_debug_company)) {
 			SetDParam(0, STR_EMPTY);
 		} else {
@@ -904,6 +918,7 @@ struct ScriptDebugWindow : public Window {
 			SetDParam(0, STR_AI_DEBUG_NAME_AND_VERSION);
 			SetDParamStr(1, info->GetName());
 			SetDParam(2, info->GetVersion());
+			this->SetMemoryStringParameters(Company::Get(script_debug_company)->ai_instance);
 		}
 	}
 
@@ -1117,6 +1132,12 @@ struct ScriptDebugWindow : public Window {
 		this->vscroll->SetCapacityFromWidget(this, WID_SCRD_LOG_PANEL, WidgetDimensions::scaled.framerect.Vertical());
 	}
 
+	void OnHundredthTick() override
+	{
+		/* Refresh the memory usage. */
+		this->SetWidgetDirty(WID_SCRD_NAME_TEXT);
+	}
+
 	static HotkeyList hotkeys;
 };
 
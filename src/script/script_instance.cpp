@@ -28,6 +28,10 @@
 #include "../company_func.h"
 #include "../fileio_func.h"
 #include "../league_type.h"
+#include "../date_func.h"
+#include "../settings_type.h"
+
+#include <chrono>
 
 #include "../safeguards.h"
 
@@ -61,9 +65,14 @@ ScriptInstance::ScriptInstance(const char *APIName, ScriptType script_type) :
 	is_paused(false),
 	in_shutdown(false),
 	callback(nullptr),
+	gc_baseline_memory(0),
+	gc_checks_since_collection(0),
+	gc_last_pause(0),
+	gc_pause_histogram({}),
 	APIName(APIName),
 	script_type(script_type),
-	allow_text_param_mismatch(false)
+	allow_text_param_mismatch(false),
+	parallel_died(false)
 {
 	this->storage = new ScriptStorage();
 	this->engine  = new Squirrel(APIName);
@@ -201,22 +210,24 @@ void ScriptInstance::Died()
 	this->engine = nullptr;
 }
 
-void ScriptInstance::GameLoop()
+/**
+ * Run the part of the GameLoop of the script which precedes resuming the VM.
+ * @return True if the VM should be resumed.
+ */
+bool ScriptInstance::PrepareGameLoop()
 {
-	ScriptObject::ActiveInstance active(this);
-
-	if (this->IsDead()) return;
+	if (this->IsDead()) return false;
 	if (this->engine->HasScriptCrashed()) {
 		/* The script crashed during saving, kill it here. */
 		this->Died();
-		return;
+		return false;
 	}
-	if (this->is_paused) return;
+	if (this->is_paused) return false;
 	this->controller->ticks++;
 
 	if (this->suspend   < -1) this->suspend++; // Multiplayer suspend, increase up to -1.
-	if (this->suspend   < 0)  return;          // Multiplayer suspend, wait for Continue().
-	if (--this->suspend > 0)  return;          // Singleplayer suspend, decrease to 0.
+	if (this->suspend   < 0)  return false;    // Multiplayer suspend, wait for Continue().
+	if (--this->suspend > 0)  return false;    // Singleplayer suspend, decrease to 0.
 
 	_current_company = ScriptObject::GetCompany();
 
@@ -232,7 +243,7 @@ void ScriptInstance::GameLoop()
 			this->suspend  = e.GetSuspendTime();
 			this->callback = e.GetSuspendCallback();
 
-			return;
+			return false;
 		}
 	}
 
@@ -247,13 +258,13 @@ void ScriptInstance::GameLoop()
 				if (!this->engine->CallMethod(*this->instance, "constructor", MAX_CONSTRUCTOR_OPS) || this->engine->IsSuspended()) {
 					if (this->engine->IsSuspended()) ScriptLog::Error("This script took too long to initialize. Script is not started.");
 					this->Died();
-					return;
+					return false;
 				}
 			}
 			if (!this->CallLoad() || this->engine->IsSuspended()) {
 				if (this->engine->IsSuspended()) ScriptLog::Error("This script took too long in the Load function. Script is not started.");
 				this->Died();
-				return;
+				return false;
 			}
 			ScriptObject::SetAllowDoCommand(true);
 			/* Start the script by calling Start() */
@@ -269,13 +280,22 @@ void ScriptInstance::GameLoop()
 		}
 
 		this->is_started = true;
-		return;
+		return false;
 	}
 	if (this->is_save_data_on_stack) {
 		sq_poptop(this->engine->GetVM());
 		this->is_save_data_on_stack = false;
 	}
 
+	return true;
+}
+
+void ScriptInstance::GameLoop()
+{
+	ScriptObject::ActiveInstance active(this);
+
+	if (!this->PrepareGameLoop()) return;
+
 	/* Continue the VM */
 	try {
 		if (!this->engine->Resume(this->GetMaxOpsTillSuspend())) this->Died();
@@ -290,14 +310,104 @@ void ScriptInstance::GameLoop()
 	}
 }
 
+bool ScriptInstance::PrepareParallelGameLoop()
+{
+	ScriptObject::ActiveInstance active(this);
+
+	return this->PrepareGameLoop();
+}
+
+void ScriptInstance::ResumeParallelGameLoop()
+{
+	ScriptObject::ActiveInstance active(this);
+
+	/* Continue the VM, anything which involves more than the VM itself is left to FinishParallelGameLoop */
+	try {
+		this->parallel_died = !this->engine->Resume(this->GetMaxOpsTillSuspend());
+	} catch (Script_Suspend &e) {
+		this->suspend  = e.GetSuspendTime();
+		this->callback = e.GetSuspendCallback();
+	} catch (Script_FatalError &e) {
+		this->parallel_fatal_error = e.GetErrorMessage();
+	}
+}
+
+void ScriptInstance::FinishParallelGameLoop()
+{
+	ScriptObject::ActiveInstance active(this);
+
+	if (this->parallel_fatal_error.has_value()) {
+		this->is_dead = true;
+		this->engine->ThrowError(this->parallel_fatal_error->c_str());
+		this->engine->ResumeError();
+		this->Died();
+		this->parallel_fatal_error.reset();
+	} else if (this->parallel_died) {
+		this->Died();
+		this->parallel_died = false;
+	}
+
+	if (this->deferred_command.has_value()) {
+		_current_company = ScriptObject::GetCompany();
+		ScriptObject::DoDeferredCommand(*this->deferred_command);
+		this->deferred_command.reset();
+	}
+}
+
+/** Minimum growth of the allocated memory of a script since its previous garbage collection, before garbage is collected again. */
+static const size_t SCRIPT_GC_MIN_GROWTH = 1 << 20;
+/** Number of garbage collection checks after which garbage is collected, regardless of the growth of the allocated memory. */
+static const uint SCRIPT_GC_MAX_INTERVAL = 2048;
+/** Upper bounds of the buckets of the garbage collection pause histogram, in microseconds. */
+static const uint32 SCRIPT_GC_PAUSE_HISTOGRAM_LIMITS[ScriptInstance::GC_PAUSE_HISTOGRAM_BUCKETS - 1] = { 1000, 5000, 25000 };
+
+static uint64 _script_gc_budget_tick = UINT64_MAX; ///< Tick in which any garbage collection last happened
+static uint32 _script_gc_budget_used = 0;          ///< Time spent collecting garbage in _script_gc_budget_tick, in microseconds
+
 void ScriptInstance::CollectGarbage()
 {
 	if (this->is_started && !this->IsDead()) {
 		ScriptObject::ActiveInstance active(this);
+
+		const auto start = std::chrono::steady_clock::now();
 		this->engine->CollectGarbage();
+		const uint32 pause = (uint32)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+		this->gc_baseline_memory = this->GetAllocatedMemory();
+		this->gc_checks_since_collection = 0;
+		this->gc_last_pause = pause;
+
+		uint bucket = 0;
+		while (bucket < lengthof(SCRIPT_GC_PAUSE_HISTOGRAM_LIMITS) && pause >= SCRIPT_GC_PAUSE_HISTOGRAM_LIMITS[bucket]) bucket++;
+		this->gc_pause_histogram[bucket]++;
+
+		if (_script_gc_budget_tick != _tick_counter) {
+			_script_gc_budget_tick = _tick_counter;
+			_script_gc_budget_used = 0;
+		}
+		_script_gc_budget_used += pause;
 	}
 }
 
+void ScriptInstance::CollectGarbageIfDue()
+{
+	if (!this->is_started || this->IsDead()) return;
+
+	this->gc_checks_since_collection++;
+
+	/* Squirrel objects are reference counted, the garbage collector only has to find unreachable cycles.
+	 * These can only pile up when the script allocates more memory, so scale the collection frequency with that. */
+	const size_t growth = std::max(this->gc_baseline_memory / 2, SCRIPT_GC_MIN_GROWTH);
+	if (this->GetAllocatedMemory() < this->gc_baseline_memory + growth && this->gc_checks_since_collection < SCRIPT_GC_MAX_INTERVAL) return;
+
+	/* The first collection in a tick always goes ahead, further ones only when the
+	 * previous pause of this script fits in what is left of the budget of this tick.
+	 * Otherwise try again next tick. */
+	if (_script_gc_budget_tick == _tick_counter && _script_gc_budget_used + this->gc_last_pause > (uint32)_settings_client.gui.script_gc_budget * 1000) return;
+
+	this->CollectGarbage();
+}
+
 /* static */ void ScriptInstance::DoCommandReturn(ScriptInstance *instance)
 {
 	instance->engine->InsertResult(ScriptObject::GetLastCommandRes());
@@ -834,6 +944,12 @@ size_t ScriptInstance::GetAllocatedMemory() const
 	return this->engine->GetAllocatedMemory();
 }
 
+size_t ScriptInstance::GetReservedMemory() const
+{
+	if (this->engine == nullptr) return 0;
+	return this->engine->GetReservedMemory();
+}
+
 void ScriptInstance::SetMemoryAllocationLimit(size_t limit) const
 {
 	if (this->engine != nullptr) this->engine->SetMemoryAllocationLimit(limit);
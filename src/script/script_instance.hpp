@@ -10,8 +10,11 @@
 #ifndef SCRIPT_INSTANCE_HPP
 #define SCRIPT_INSTANCE_HPP
 
+#include <array>
 #include <variant>
 #include <list>
+#include <optional>
+#include <string>
 #include <squirrel.h>
 #include "squirrel.hpp"
 #include "script_suspend.hpp"
@@ -84,11 +87,47 @@ public:
 	 */
 	void GameLoop();
 
+	/**
+	 * Run the first part of the GameLoop of a script which is run in parallel with other scripts.
+	 * This is run on the game thread.
+	 * @return True if the VM of the script should be resumed by ResumeParallelGameLoop.
+	 */
+	bool PrepareParallelGameLoop();
+
+	/**
+	 * Resume the VM of a script which is run in parallel with other scripts.
+	 * This may be run on a worker thread, with _script_parallel_active set.
+	 */
+	void ResumeParallelGameLoop();
+
+	/**
+	 * Handle the outcome of resuming the VM of a script which was run in parallel with other scripts,
+	 * and execute any DoCommand it made. This is run on the game thread, in company order.
+	 */
+	void FinishParallelGameLoop();
+
+	/** Number of buckets in the garbage collection pause histogram, see #GetGCPauseHistogram */
+	static const uint GC_PAUSE_HISTOGRAM_BUCKETS = 4;
+	typedef std::array<uint32, GC_PAUSE_HISTOGRAM_BUCKETS> GCPauseHistogram;
+
 	/**
 	 * Let the VM collect any garbage.
 	 */
 	void CollectGarbage();
 
+	/**
+	 * Let the VM collect any garbage, if enough memory was allocated since the previous
+	 *  collection or the previous collection was long ago, and the garbage collection
+	 *  budget of the current tick allows it.
+	 */
+	void CollectGarbageIfDue();
+
+	/**
+	 * Get the number of garbage collections of this script, by pause duration:
+	 *  under 1 ms, under 5 ms, under 25 ms and 25 ms or more.
+	 */
+	const GCPauseHistogram &GetGCPauseHistogram() const { return this->gc_pause_histogram; }
+
 	/**
 	 * Get the storage of this script.
 	 */
@@ -241,6 +280,11 @@ public:
 
 	size_t GetAllocatedMemory() const;
 
+	/**
+	 * Get the amount of memory reserved by the script VM, including unused pooled memory.
+	 */
+	size_t GetReservedMemory() const;
+
 	void SetMemoryAllocationLimit(size_t limit) const;
 
 	/**
@@ -299,10 +343,23 @@ private:
 	bool in_shutdown;                     ///< Is this instance currently being destructed?
 	Script_SuspendCallbackProc *callback; ///< Callback that should be called in the next tick the script runs.
 	size_t last_allocated_memory;         ///< Last known allocated memory value (for display for crashed scripts)
+	size_t gc_baseline_memory;            ///< Allocated memory just after the previous garbage collection
+	uint gc_checks_since_collection;      ///< Number of garbage collection checks since the previous garbage collection
+	uint32 gc_last_pause;                 ///< Duration of the previous garbage collection, in microseconds
+	GCPauseHistogram gc_pause_histogram;  ///< Number of garbage collections, by pause duration
 	const char *APIName;                  ///< Name of the API used for this squirrel.
 	ScriptType script_type;               ///< Script type.
 	bool allow_text_param_mismatch;       ///< Whether ScriptText parameter mismatches are allowed
 
+	bool parallel_died;                                 ///< Whether the script died whilst scripts were run in parallel
+	std::optional<std::string> parallel_fatal_error;    ///< Fatal error raised whilst scripts were run in parallel
+	std::optional<CommandContainer> deferred_command;   ///< DoCommand to execute once all scripts have been run in parallel
+
+	/**
+	 * Run the part of the GameLoop of the script preceding resuming the VM.
+	 */
+	bool PrepareGameLoop();
+
 	/**
 	 * Call the script Load function if it exists and data was loaded
 	 *  from a savegame.
@@ -0,0 +1,49 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file script_parallel.cpp Support for running script instances in parallel. */
+
+#include "../stdafx.h"
+#include "script_parallel.hpp"
+#include "api/script_object.hpp"
+#include "../company_func.h"
+
+#include <mutex>
+#if defined(__MINGW32__)
+#include "../3rdparty/mingw-std-threads/mingw.mutex.h"
+#endif
+
+#include "../safeguards.h"
+
+bool _script_parallel_active = false;
+
+static std::recursive_mutex _script_parallel_api_mutex;
+static thread_local uint _script_parallel_api_depth = 0;
+static CompanyID _script_parallel_api_saved_company; ///< Current company before the outermost lock was taken, protected by the lock
+
+/**
+ * Take the lock serialising calls from scripts into the game.
+ * The current company is set to that of the calling script, as another script may have changed it.
+ * It is restored when the lock is released.
+ */
+void ScriptParallelApiLock()
+{
+	_script_parallel_api_mutex.lock();
+	if (_script_parallel_api_depth++ == 0) {
+		_script_parallel_api_saved_company = _current_company;
+		_current_company = ScriptObject::GetCompany();
+	}
+}
+
+/**
+ * Release the lock serialising calls from scripts into the game.
+ */
+void ScriptParallelApiUnlock()
+{
+	if (--_script_parallel_api_depth == 0) _current_company = _script_parallel_api_saved_company;
+	_script_parallel_api_mutex.unlock();
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file script_parallel.hpp Support for running script instances in parallel. */
+
+#ifndef SCRIPT_PARALLEL_HPP
+#define SCRIPT_PARALLEL_HPP
+
+/** Whether script instances are currently being run in parallel, this is only changed by the game thread whilst no scripts are running. */
+extern bool _script_parallel_active;
+
+void ScriptParallelApiLock();
+void ScriptParallelApiUnlock();
+
+/**
+ * Scope of a call from a script into the game.
+ * Whilst script instances are run in parallel only the execution of Squirrel code itself
+ * is concurrent, calls into the game are serialised by this, as they read game state and
+ * use various global variables.
+ */
+class ScriptParallelApiScope {
+	bool locked; ///< Whether the API lock was taken by this scope
+
+public:
+	inline ScriptParallelApiScope() : locked(_script_parallel_active)
+	{
+		if (this->locked) ScriptParallelApiLock();
+	}
+
+	inline ~ScriptParallelApiScope()
+	{
+		if (this->locked) ScriptParallelApiUnlock();
+	}
+
+	ScriptParallelApiScope(const ScriptParallelApiScope &copysrc) = delete;
+};
+
+#endif /* SCRIPT_PARALLEL_HPP */
@@ -13,6 +13,7 @@
 #include "../fileio_func.h"
 #include "../string_func.h"
 #include "script_fatalerror.hpp"
+#include "script_parallel.hpp"
 #include "../settings_type.h"
 #include <sqstdaux.h>
 #include <../squirrel/sqpcheader.h>
@@ -20,7 +21,9 @@
 #include "../core/alloc_func.hpp"
 
 #include <stdarg.h>
+#include <array>
 #include <map>
+#include <vector>
 
 /**
  * In the memory allocator for Squirrel we want to directly use malloc/realloc, so when the OS
@@ -36,6 +39,17 @@
 #define SCRIPT_DEBUG_ALLOCATIONS
 */
 
+/**
+ * Per-VM allocator for Squirrel.
+ *
+ * Small allocations, which make up the bulk of Squirrel's objects (strings, table nodes,
+ * closures, class instances, etc.), are rounded up to a size class and carved out of large
+ * chunks, with a free list per size class. This avoids going to the general heap for every
+ * allocation, which is both slow and fragments the heap when several scripts are running.
+ * The chunks are only returned to the OS when the allocator is destroyed, i.e. when the
+ * script is unloaded or killed.
+ * Larger allocations (arrays, table node vectors, etc.) are passed directly to malloc.
+ */
 struct ScriptAllocator {
 	size_t allocated_size;   ///< Sum of allocated data size
 	size_t allocation_limit; ///< Maximum this allocator may use before allocations fail
@@ -49,6 +63,22 @@ struct ScriptAllocator {
 
 	static const size_t SAFE_LIMIT = 0x8000000; ///< 128 MiB, a safe choice for almost any situation
 
+	static const size_t SIZE_CLASS_GRANULARITY = 16; ///< Size step between size classes, this is also the alignment of pooled blocks
+	static const size_t SIZE_CLASS_COUNT = 32;       ///< Number of size classes
+	static const size_t MAX_POOLED_SIZE = SIZE_CLASS_GRANULARITY * SIZE_CLASS_COUNT; ///< Largest allocation size which is pooled
+	static const size_t CHUNK_SIZE = 64 * 1024;      ///< Size of the chunks which pooled blocks are carved out of
+
+	/** Header of an unused pooled block */
+	struct FreeBlock {
+		FreeBlock *next; ///< Next free block of the same size class
+	};
+
+	std::array<FreeBlock *, SIZE_CLASS_COUNT> free_lists; ///< Unused pooled blocks, per size class
+	std::vector<char *> chunks; ///< All chunks which have been allocated
+	char *chunk_pos;            ///< Next unused byte of the most recent chunk
+	char *chunk_end;            ///< End of the most recent chunk
+	size_t large_size;          ///< Sum of the sizes of the allocations which are too large to be pooled
+
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 	std::map<void *, size_t> allocations;
 #endif
@@ -59,15 +89,13 @@ struct ScriptAllocator {
 	}
 
 	/**
-	 * Catch all validation for the allocation; did it allocate too much memory according
-	 * to the allocation limit or did the allocation at the OS level maybe fail? In those
-	 * error situations a Script_FatalError is thrown, but once that has been done further
+	 * Check whether an allocation would exceed the allocation limit, before performing it.
+	 * In this case a Script_FatalError is thrown, but once that has been done further
 	 * allocations are allowed to make it possible for Squirrel to throw the error and
 	 * clean everything up.
-	 * @param requested_size The requested size that was requested to be allocated.
-	 * @param p              The pointer to the allocated object, or null if allocation failed.
+	 * @param requested_size The size that is about to be allocated, in addition to what is already allocated.
 	 */
-	void CheckAllocation(size_t requested_size, void *p)
+	void CheckAllocationLimit(size_t requested_size)
 	{
 		if (this->allocated_size + requested_size > this->allocation_limit && !this->error_thrown) {
 			/* Do not allow allocating more than the allocation limit, except when an error is
@@ -77,11 +105,17 @@ struct ScriptAllocator {
 			char buff[128];
 			seprintf(buff, lastof(buff), "Maximum memory allocation exceeded by " PRINTF_SIZE " bytes when allocating " PRINTF_SIZE " bytes",
 				this->allocated_size + requested_size - this->allocation_limit, requested_size);
-			/* Don't leak the rejected allocation. */
-			free(p);
 			throw Script_FatalError(buff);
 		}
+	}
 
+	/**
+	 * Check whether the allocation at the OS level failed, in which case a Script_FatalError is thrown.
+	 * @param requested_size The requested size that was requested to be allocated.
+	 * @param p              The pointer to the allocated object, or null if allocation failed.
+	 */
+	void CheckAllocationResult(size_t requested_size, void *p)
+	{
 		if (p == nullptr) {
 			/* The OS did not have enough memory to allocate the object, regardless of the
 			 * limit imposed by OpenTTD on the amount of memory that may be allocated. */
@@ -99,11 +133,81 @@ struct ScriptAllocator {
 		}
 	}
 
-	void *Malloc(SQUnsignedInteger size)
+	static inline size_t GetSizeClass(size_t size)
+	{
+		return size == 0 ? 0 : (size - 1) / SIZE_CLASS_GRANULARITY;
+	}
+
+	static inline size_t GetSizeClassBlockSize(size_t size_class)
+	{
+		return (size_class + 1) * SIZE_CLASS_GRANULARITY;
+	}
+
+	void PushFreeBlock(void *p, size_t size_class)
 	{
+		FreeBlock *block = static_cast<FreeBlock *>(p);
+		block->next = this->free_lists[size_class];
+		this->free_lists[size_class] = block;
+	}
+
+	/**
+	 * Get a pooled block of the given size class.
+	 * @param size_class Size class.
+	 * @return The block, or null if a new chunk was required but could not be allocated.
+	 */
+	void *AllocateBlock(size_t size_class)
+	{
+		FreeBlock *block = this->free_lists[size_class];
+		if (block != nullptr) {
+			this->free_lists[size_class] = block->next;
+			return block;
+		}
+
+		const size_t block_size = GetSizeClassBlockSize(size_class);
+		if (static_cast<size_t>(this->chunk_end - this->chunk_pos) < block_size) {
+			char *chunk = static_cast<char *>(malloc(CHUNK_SIZE));
+			if (chunk == nullptr) return nullptr;
+
+			/* Everything is a multiple of the granularity, so the tail of the previous chunk always fits a size class. */
+			const size_t remaining = this->chunk_end - this->chunk_pos;
+			if (remaining > 0) this->PushFreeBlock(this->chunk_pos, GetSizeClass(remaining));
+
+			this->chunks.push_back(chunk);
+			this->chunk_pos = chunk;
+			this->chunk_end = chunk + CHUNK_SIZE;
+		}
+
+		void *p = this->chunk_pos;
+		this->chunk_pos += block_size;
+		return p;
+	}
+
+	void *AllocateRaw(size_t size)
+	{
+		if (size <= MAX_POOLED_SIZE) return this->AllocateBlock(GetSizeClass(size));
+
 		void *p = malloc(size);
+		if (p != nullptr) this->large_size += size;
+		return p;
+	}
 
-		this->CheckAllocation(size, p);
+	void FreeRaw(void *p, size_t size)
+	{
+		if (size <= MAX_POOLED_SIZE) {
+			this->PushFreeBlock(p, GetSizeClass(size));
+		} else {
+			free(p);
+			this->large_size -= size;
+		}
+	}
+
+	void *Malloc(SQUnsignedInteger size)
+	{
+		this->CheckAllocationLimit(size);
+
+		void *p = this->AllocateRaw(size);
+
+		this->CheckAllocationResult(size, p);
 
 		this->allocated_size += size;
 
@@ -126,28 +230,34 @@ struct ScriptAllocator {
 			return nullptr;
 		}
 
+		/* If memory exception is thrown, the old pointer is expected
+		 * to be valid for engine cleanup. */
+		this->CheckAllocationLimit(size - oldsize);
+
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 		assert(this->allocations[p] == oldsize);
 		this->allocations.erase(p);
 #endif
-		/* Can't use realloc directly because memory limit check.
-		 * If memory exception is thrown, the old pointer is expected
-		 * to be valid for engine cleanup.
-		 */
-		void *new_p = malloc(size);
 
-		this->CheckAllocation(size - oldsize, new_p);
+		void *new_p;
+		if (oldsize <= MAX_POOLED_SIZE && size <= MAX_POOLED_SIZE && GetSizeClass(oldsize) == GetSizeClass(size)) {
+			/* The existing block is already big enough. */
+			new_p = p;
+		} else {
+			new_p = this->AllocateRaw(size);
 
-		/* Memory limit test passed, we can copy data and free old pointer. */
-		memcpy(new_p, p, std::min(oldsize, size));
-		free(p);
+			this->CheckAllocationResult(size, new_p);
+
+			memcpy(new_p, p, std::min(oldsize, size));
+			this->FreeRaw(p, oldsize);
+		}
 
 		this->allocated_size -= oldsize;
 		this->allocated_size += size;
 
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 		assert(new_p != nullptr);
-		assert(this->allocations.find(p) == this->allocations.end());
+		assert(this->allocations.find(new_p) == this->allocations.end());
 		this->allocations[new_p] = size;
 #endif
 
@@ -157,7 +267,7 @@ struct ScriptAllocator {
 	void Free(void *p, SQUnsignedInteger size)
 	{
 		if (p == nullptr) return;
-		free(p);
+		this->FreeRaw(p, size);
 		this->allocated_size -= size;
 
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
@@ -166,12 +276,24 @@ struct ScriptAllocator {
 #endif
 	}
 
+	/**
+	 * Get the amount of memory reserved from the OS, including unused pooled blocks.
+	 */
+	size_t GetReservedSize() const
+	{
+		return (this->chunks.size() * CHUNK_SIZE) + this->large_size;
+	}
+
 	ScriptAllocator()
 	{
 		this->allocated_size = 0;
 		this->allocation_limit = static_cast<size_t>(_settings_game.script.script_max_memory_megabytes) << 20;
 		if (this->allocation_limit == 0) this->allocation_limit = SAFE_LIMIT; // in case the setting is somehow zero
 		this->error_thrown = false;
+		this->free_lists.fill(nullptr);
+		this->chunk_pos = nullptr;
+		this->chunk_end = nullptr;
+		this->large_size = 0;
 	}
 
 	~ScriptAllocator()
@@ -179,6 +301,10 @@ struct ScriptAllocator {
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 		assert(this->allocations.size() == 0);
 #endif
+		/* Release all pooled blocks in one go, regardless of whether they were freed individually. */
+		for (char *chunk : this->chunks) {
+			free(chunk);
+		}
 	}
 };
 
@@ -190,7 +316,7 @@ struct ScriptAllocator {
  */
 #include "../safeguards.h"
 
-ScriptAllocator *_squirrel_allocator = nullptr;
+thread_local ScriptAllocator *_squirrel_allocator = nullptr;
 
 /* See 3rdparty/squirrel/squirrel/sqmem.cpp for the default allocator implementation, which this overrides */
 #ifndef SQUIRREL_DEFAULT_ALLOCATOR
@@ -205,6 +331,12 @@ size_t Squirrel::GetAllocatedMemory() const noexcept
 	return this->allocator->allocated_size;
 }
 
+size_t Squirrel::GetReservedMemory() const noexcept
+{
+	assert(this->allocator != nullptr);
+	return this->allocator->GetReservedSize();
+}
+
 void Squirrel::SetMemoryAllocationLimit(size_t limit) noexcept
 {
 	if (this->allocator != nullptr) {
@@ -219,6 +351,8 @@ void Squirrel::CompileError(HSQUIRRELVM vm, const SQChar *desc, const SQChar *so
 
 	seprintf(buf, lastof(buf), "Error %s:" OTTD_PRINTF64 "/" OTTD_PRINTF64 ": %s", source, line, column, desc);
 
+	ScriptParallelApiScope api_scope;
+
 	/* Check if we have a custom print function */
 	Squirrel *engine = (Squirrel *)sq_getforeignptr(vm);
 	engine->crashed = true;
@@ -239,6 +373,8 @@ void Squirrel::ErrorPrintFunc(HSQUIRRELVM vm, const SQChar *s, ...)
 	vseprintf(buf, lastof(buf), s, arglist);
 	va_end(arglist);
 
+	ScriptParallelApiScope api_scope;
+
 	/* Check if we have a custom print function */
 	SQPrintFunc *func = ((Squirrel *)sq_getforeignptr(vm))->print_func;
 	if (func == nullptr) {
@@ -250,6 +386,8 @@ void Squirrel::ErrorPrintFunc(HSQUIRRELVM vm, const SQChar *s, ...)
 
 void Squirrel::RunError(HSQUIRRELVM vm, const SQChar *error)
 {
+	ScriptParallelApiScope api_scope;
+
 	/* Set the print function to something that prints to stderr */
 	SQPRINTFUNCTION pf = sq_getprintfunc(vm);
 	sq_setprintfunc(vm, &Squirrel::ErrorPrintFunc);
@@ -296,6 +434,8 @@ void Squirrel::PrintFunc(HSQUIRRELVM vm, const SQChar *s, ...)
 	va_end(arglist);
 	strecat(buf, "\n", lastof(buf));
 
+	ScriptParallelApiScope api_scope;
+
 	/* Check if we have a custom print function */
 	SQPrintFunc *func = ((Squirrel *)sq_getforeignptr(vm))->print_func;
 	if (func == nullptr) {
@@ -281,11 +281,16 @@ public:
 	 */
 	size_t GetAllocatedMemory() const noexcept;
 
+	/**
+	 * Get number of bytes reserved from the OS by this VM, including unused pooled memory.
+	 */
+	size_t GetReservedMemory() const noexcept;
+
 	void SetMemoryAllocationLimit(size_t limit) noexcept;
 };
 
 
-extern ScriptAllocator *_squirrel_allocator;
+extern thread_local ScriptAllocator *_squirrel_allocator;
 
 class ScriptAllocatorScope {
 	ScriptAllocator *old_allocator;
@@ -12,6 +12,7 @@
 #include <sqstdmath.h>
 #include "../debug.h"
 #include "squirrel_std.hpp"
+#include "script_parallel.hpp"
 #include "../core/alloc_func.hpp"
 #include "../core/math_func.hpp"
 #include "../string_func.h"
@@ -41,6 +42,8 @@ SQInteger SquirrelStd::max(HSQUIRRELVM vm)
 
 SQInteger SquirrelStd::require(HSQUIRRELVM vm)
 {
+	ScriptParallelApiScope api_scope;
+
 	SQInteger top = sq_gettop(vm);
 	const SQChar *filename;
 
@@ -154,6 +154,8 @@ struct GUISettings : public TimeSettings {
 	uint16 autosave_custom_days;             ///< custom autosave interval in days
 	uint16 autosave_custom_minutes;          ///< custom autosave interval in real-time minutes
 	bool   threaded_saves;                   ///< should we do threaded saves?
+	bool   parallel_ai_scripts;              ///< should the scripts of AI companies be run in parallel?
+	uint16 script_gc_budget;                 ///< time budget for collecting script garbage in one tick, in milliseconds
 	bool   keep_all_autosave;                ///< name the autosave in a different way
 	bool   autosave_on_exit;                 ///< save an autosave when you quit the game, but do not ask "Do you really want to quit?"
 	bool   autosave_on_network_disconnect;   ///< save an autosave when you get disconnected from a network game with an error?
@@ -574,6 +576,7 @@ struct YAPFSettings {
 	uint32 rail_shorter_platform_per_tile_penalty; ///< penalty for shorter station platform than train (per tile)
 	uint32 ship_curve45_penalty;                   ///< penalty for 45-deg curve for ships
 	uint32 ship_curve90_penalty;                   ///< penalty for 90-deg curve for ships
+	bool   ship_use_water_regions;                 ///< guide ship pathfinding using a search of the water region graph
 };
 
 /** Settings related to all pathfinders. */
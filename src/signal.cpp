@@ -26,6 +26,10 @@
 #include "core/checksum_func.hpp"
 #include "core/hash_func.hpp"
 #include "pathfinder/follow_track.hpp"
+#include "zone_profiler.h"
+
+#include <algorithm>
+#include <vector>
 
 #include "safeguards.h"
 
@@ -71,11 +75,16 @@ static const TrackdirBits _enterdir_to_trackdirbits[DIAGDIR_END] = {
 /**
  * Set containing 'items' items of 'tile and Tdir'
  * No tree structure is used because it would cause
- * slowdowns in most usual cases
+ * slowdowns in most usual cases.
+ * A count of items per hash bucket is kept, so that looking up items
+ * which are not in the set does not usually need to scan the set,
+ * the order of the items is not affected by this.
  */
 template <typename Tdir, uint items>
 struct SmallSet {
 private:
+	static const uint HASH_BUCKETS = 128;
+
 	uint n;           // actual number of units
 	bool overflowed;  // did we try to overflow the set?
 	const char *name; // name, used for debugging purposes...
@@ -86,15 +95,23 @@ private:
 		Tdir dir;
 	} data[items];
 
+	uint16 bucket_counts[HASH_BUCKETS]; // number of elements in each hash bucket
+
+	static inline uint Bucket(TileIndex tile, Tdir dir)
+	{
+		return ((uint32)tile * 0x9E3779B1 + (uint32)(uint8)dir * 0x85EBCA6B) >> 25;
+	}
+
 public:
 	/** Constructor - just set default values and 'name' */
-	SmallSet(const char *name) : n(0), overflowed(false), name(name) { }
+	SmallSet(const char *name) : n(0), overflowed(false), name(name), bucket_counts() { }
 
 	/** Reset variables to default values */
 	void Reset()
 	{
 		this->n = 0;
 		this->overflowed = false;
+		memset(this->bucket_counts, 0, sizeof(this->bucket_counts));
 	}
 
 	/**
@@ -142,9 +159,13 @@ public:
 	 */
 	bool Remove(TileIndex tile, Tdir dir)
 	{
+		const uint bucket = Bucket(tile, dir);
+		if (this->bucket_counts[bucket] == 0) return false;
+
 		for (uint i = 0; i < this->n; i++) {
 			if (this->data[i].tile == tile && this->data[i].dir == dir) {
 				this->data[i] = this->data[--this->n];
+				this->bucket_counts[bucket]--;
 				return true;
 			}
 		}
@@ -160,6 +181,8 @@ public:
 	 */
 	bool IsIn(TileIndex tile, Tdir dir)
 	{
+		if (this->bucket_counts[Bucket(tile, dir)] == 0) return false;
+
 		for (uint i = 0; i < this->n; i++) {
 			if (this->data[i].tile == tile && this->data[i].dir == dir) return true;
 		}
@@ -185,6 +208,7 @@ public:
 		this->data[this->n].tile = tile;
 		this->data[this->n].dir = dir;
 		this->n++;
+		this->bucket_counts[Bucket(tile, dir)]++;
 
 		return true;
 	}
@@ -202,6 +226,7 @@ public:
 		this->n--;
 		*tile = this->data[this->n].tile;
 		*dir = this->data[this->n].dir;
+		this->bucket_counts[Bucket(*tile, *dir)]--;
 
 		return true;
 	}
@@ -579,8 +604,17 @@ static uint8 GetSignalledTunnelBridgeEntranceForwardAspect(TileIndex tile, TileI
 	}
 }
 
-uint8 GetForwardAspectFollowingTrack(TileIndex tile, Trackdir trackdir)
+/**
+ * Get the aspect of the next signal ahead of a signal, following the track and any reservations at junctions.
+ * @param tile Tile of the signal.
+ * @param trackdir Trackdir of the signal.
+ * @param[out] signal_tile If not nullptr, set to the tile of the next signal if it is a signal on a rail tile, or INVALID_TILE otherwise.
+ * @param[out] signal_trackdir If not nullptr, set to the trackdir of the next signal if it is a signal on a rail tile.
+ * @return The aspect of the next signal.
+ */
+uint8 GetForwardAspectFollowingTrack(TileIndex tile, Trackdir trackdir, TileIndex *signal_tile, Trackdir *signal_trackdir)
 {
+	if (signal_tile != nullptr) *signal_tile = INVALID_TILE;
 	Owner owner = GetTileOwner(tile);
 	DiagDirection exitdir = TrackdirToExitdir(trackdir);
 	DiagDirection enterdir = ReverseDiagDir(exitdir);
@@ -622,6 +656,8 @@ uint8 GetForwardAspectFollowingTrack(TileIndex tile, Trackdir trackdir)
 				if (HasSignals(tile)) {
 					if (HasSignalOnTrack(tile, track)) { // now check whole track, not trackdir
 						if (HasSignalOnTrackdir(tile, trackdir)) {
+							if (signal_tile != nullptr) *signal_tile = tile;
+							if (signal_trackdir != nullptr) *signal_trackdir = trackdir;
 							if (GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_RED) return 0;
 							uint8 aspect = GetSignalAspect(tile, track);
 							AdjustSignalAspectIfNonIncStyle(tile, track, aspect);
@@ -921,6 +957,8 @@ static inline void ResetSets()
  */
 static SigSegState UpdateSignalsInBuffer(Owner owner)
 {
+	ZONE_PROFILE("UpdateSignalsInBuffer");
+
 	assert(Company::IsValidID(owner));
 
 	bool first = true;  // first block?
@@ -1491,18 +1529,68 @@ void UpdateLookaheadCombinedNormalShuntSignalDeferred(TileIndex tile, Trackdir t
 	_deferred_lookahead_combined_normal_shunt_mode.push_back({ tile, trackdir, lookahead_position });
 }
 
+/** Is this a rail signal which has just changed to green, and so still needs an aspect to be set? */
+static inline bool IsRailSignalAwaitingAspect(TileIndex tile, Trackdir trackdir)
+{
+	return IsTileType(tile, MP_RAILWAY) && HasSignalOnTrackdir(tile, trackdir) && GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN && GetSignalAspect(tile, TrackdirToTrack(trackdir)) == 0;
+}
+
+/**
+ * Set the aspect of a rail signal which has just changed to green, and propagate it backwards.
+ * If the next signal ahead is also still waiting for its aspect, it is updated first, as its propagation
+ * usually also sets the aspect of this signal. This avoids propagating the same chain of signals twice.
+ * @param tile Tile of the signal.
+ * @param trackdir Trackdir of the signal.
+ * @param pending Sorted list of signals still to be updated in this flush.
+ */
+static void UpdateDeferredRailSignalAspect(TileIndex tile, Trackdir trackdir, const std::vector<std::pair<TileIndex, Trackdir>> &pending)
+{
+	/* Signals behind the current one, waiting for the signals ahead of them to be updated first */
+	static std::vector<std::pair<TileIndex, Trackdir>> chain;
+	chain.clear();
+
+	while (true) {
+		TileIndex next_tile;
+		Trackdir next_trackdir;
+		uint8 forward_aspect = GetForwardAspectFollowingTrack(tile, trackdir, &next_tile, &next_trackdir);
+		const std::pair<TileIndex, Trackdir> next(next_tile, next_trackdir);
+		if (next_tile != INVALID_TILE && chain.size() < pending.size() && std::binary_search(pending.begin(), pending.end(), next) &&
+				IsRailSignalAwaitingAspect(next_tile, next_trackdir) && std::find(chain.begin(), chain.end(), next) == chain.end() &&
+				next != std::make_pair(tile, trackdir)) {
+			chain.push_back({ tile, trackdir });
+			tile = next_tile;
+			trackdir = next_trackdir;
+			continue;
+		}
+
+		uint8 aspect = IncrementAspectForSignal(forward_aspect, IsRailCombinedNormalShuntSignalStyle(tile, TrackdirToTrack(trackdir)));
+		SetSignalAspect(tile, TrackdirToTrack(trackdir), aspect);
+		PropagateAspectChange(tile, trackdir, aspect);
+
+		/* Continue with the signals behind which were not reached by the propagation */
+		do {
+			if (chain.empty()) return;
+			tile = chain.back().first;
+			trackdir = chain.back().second;
+			chain.pop_back();
+		} while (!IsRailSignalAwaitingAspect(tile, trackdir));
+	}
+}
+
 void FlushDeferredAspectUpdates()
 {
+	static std::vector<std::pair<TileIndex, Trackdir>> pending;
+	pending.assign(_deferred_aspect_updates.begin(), _deferred_aspect_updates.end());
+	std::sort(pending.begin(), pending.end());
+
 	/* Iterate in reverse order to reduce backtracking when updating the aspects of a new reservation */
 	for (auto iter = _deferred_aspect_updates.rbegin(); iter != _deferred_aspect_updates.rend(); ++iter) {
 		TileIndex tile = iter->first;
 		Trackdir trackdir = iter->second;
 		switch (GetTileType(tile)) {
 			case MP_RAILWAY:
-				if (HasSignalOnTrackdir(tile, trackdir) && GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN && GetSignalAspect(tile, TrackdirToTrack(trackdir)) == 0) {
-					uint8 aspect = GetForwardAspectFollowingTrackAndIncrement(tile, trackdir, IsRailCombinedNormalShuntSignalStyle(tile, TrackdirToTrack(trackdir)));
-					SetSignalAspect(tile, TrackdirToTrack(trackdir), aspect);
-					PropagateAspectChange(tile, trackdir, aspect);
+				if (IsRailSignalAwaitingAspect(tile, trackdir)) {
+					UpdateDeferredRailSignalAspect(tile, trackdir, pending);
 				}
 				break;
 
@@ -186,7 +186,7 @@ void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner);
 void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner);
 void UpdateSignalsInBuffer();
 void UpdateSignalsInBufferIfOwnerNotAddable(Owner owner);
-uint8 GetForwardAspectFollowingTrack(TileIndex tile, Trackdir trackdir);
+uint8 GetForwardAspectFollowingTrack(TileIndex tile, Trackdir trackdir, TileIndex *signal_tile = nullptr, Trackdir *signal_trackdir = nullptr);
 uint8 GetSignalAspectGeneric(TileIndex tile, Trackdir trackdir, bool check_non_inc_style);
 void PropagateAspectChange(TileIndex tile, Trackdir trackdir, uint8 aspect);
 void UpdateAspectDeferred(TileIndex tile, Trackdir trackdir);
@@ -52,7 +52,7 @@ void RebuildTownCaches(bool cargo_update_required, bool old_map_position)
 
 		HouseID house_id = GetTranslatedHouseID(SLGetCleanHouseType(t, old_map_position));
 		Town *town = Town::GetByTile(t);
-		IncreaseBuildingCount(town, house_id);
+		IncreaseBuildingCount(town, house_id, t);
 		if (IsHouseCompleted(t)) town->cache.population += HouseSpec::Get(house_id)->population;
 
 		/* Increase the number of houses for every house, but only once. */
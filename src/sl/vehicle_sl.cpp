@@ -1513,6 +1513,7 @@ void Load_VLKA()
 		t->lookahead->items.resize(items);
 		for (uint i = 0; i < items; i++) {
 			SlObject(&t->lookahead->items[i], GetVehicleLookAheadItemDescription());
+			t->lookahead->items_min_z = std::min(t->lookahead->items_min_z, t->lookahead->items[i].z_pos);
 		}
 		uint32 curves = SlReadUint32();
 		t->lookahead->curves.resize(curves);
@@ -485,6 +485,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 {
 	this->industries_near.clear();
 	if (!no_clear_nearby_lists) this->RemoveFromAllNearbyLists();
+	this->catchment_acceptance_valid = false;
 
 	if (this->rect.IsEmpty()) {
 		this->catchment_tiles.Reset();
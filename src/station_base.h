@@ -825,6 +825,10 @@ public:
 	BitmapTileArea catchment_tiles; ///< NOSAVE: Set of individual tiles covered by catchment area
 	uint station_tiles;             ///< NOSAVE: Count of station tiles owned by this station
 
+	CargoArray catchment_acceptance;            ///< NOSAVE: Acceptance of the catchment tiles as of the last catchment scan, see UpdateStationAcceptance()
+	bool catchment_acceptance_valid = false;    ///< NOSAVE: Whether catchment_acceptance is up to date, see InvalidateStationCatchmentAcceptance()
+	bool catchment_acceptance_volatile = false; ///< NOSAVE: Whether the catchment contains tiles with callback-determined acceptance, which must be rescanned every time
+
 	StationHadVehicleOfType had_vehicle_of_type;
 
 	byte time_since_load;
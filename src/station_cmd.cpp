@@ -51,6 +51,7 @@
 #include "newgrf_airporttiles.h"
 #include "order_backup.h"
 #include "newgrf_house.h"
+#include "newgrf_industrytiles.h"
 #include "company_gui.h"
 #include "linkgraph/linkgraph_base.h"
 #include "linkgraph/refresh.h"
@@ -643,24 +644,82 @@ CargoArray GetAcceptanceAroundTiles(TileIndex center_tile, int w, int h, int rad
 	return acceptance;
 }
 
+/**
+ * Check whether the acceptance of a tile is determined by NewGRF callbacks or
+ * other state which can change without the tile itself being rebuilt.
+ * @param tile Tile to check.
+ * @return true if the acceptance of the tile cannot be cached.
+ */
+static bool IsTileAcceptanceVolatile(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_HOUSE: {
+			const HouseSpec *hs = HouseSpec::Get(GetHouseType(tile));
+			return HasBit(hs->callback_mask, CBM_HOUSE_ACCEPT_CARGO) || HasBit(hs->callback_mask, CBM_HOUSE_CARGO_ACCEPTANCE);
+		}
+
+		case MP_INDUSTRY: {
+			const IndustryTileSpec *itspec = GetIndustryTileSpec(GetIndustryGfx(tile));
+			return HasBit(itspec->callback_mask, CBM_INDT_ACCEPT_CARGO) || HasBit(itspec->callback_mask, CBM_INDT_CARGO_ACCEPTANCE) ||
+					(itspec->special_flags & INDTILE_SPECIAL_ACCEPTS_ALL_CARGO);
+		}
+
+		default:
+			return false;
+	}
+}
+
 /**
  * Get the acceptance of cargoes around the station in.
  * @param st Station to get acceptance of.
  * @param always_accepted bitmask of cargo accepted by houses and headquarters; can be nullptr
+ * @param is_volatile set to whether any tile in the catchment has acceptance which cannot be cached, see IsTileAcceptanceVolatile()
  */
-static CargoArray GetAcceptanceAroundStation(const Station *st, CargoTypes *always_accepted)
+static CargoArray GetAcceptanceAroundStation(const Station *st, CargoTypes *always_accepted, bool &is_volatile)
 {
 	CargoArray acceptance;
 	if (always_accepted != nullptr) *always_accepted = 0;
+	is_volatile = false;
 
 	BitmapTileIterator it(st->catchment_tiles);
 	for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
 		AddAcceptedCargo(tile, acceptance, always_accepted);
+		if (!is_volatile) is_volatile = IsTileAcceptanceVolatile(tile);
 	}
 
 	return acceptance;
 }
 
+/**
+ * Invalidate the cached catchment acceptance of all stations whose catchment covers any part of the given area.
+ * This must be called whenever a tile which can accept cargo is built, removed or changes type.
+ * @param ta The changed area.
+ */
+void InvalidateStationCatchmentAcceptance(const TileArea &ta)
+{
+	if (Station::GetNumItems() == 0) return;
+
+	/* Station signs are at most station_spread tiles from any station tile, and the catchment extends at most max_c beyond that. */
+	uint max_c = _settings_game.station.modified_catchment ? MAX_CATCHMENT : CA_UNMODIFIED;
+	int radius = max_c + _settings_game.station.catchment_increase + _settings_game.station.station_spread;
+
+	uint32 x1 = (uint32)std::max<int>(0, TileX(ta.tile) - radius);
+	uint32 y1 = (uint32)std::max<int>(0, TileY(ta.tile) - radius);
+	uint32 x2 = (uint32)std::min<int>(TileX(ta.tile) + ta.w + radius, MapSizeX());
+	uint32 y2 = (uint32)std::min<int>(TileY(ta.tile) + ta.h + radius, MapSizeY());
+
+	_station_kdtree.FindContained(x1, y1, x2, y2, [&](StationID id) {
+		Station *st = Station::Get(id);
+		if (!st->catchment_acceptance_valid) return;
+		for (TileIndex tile : ta) {
+			if (st->TileIsInCatchment(tile)) {
+				st->catchment_acceptance_valid = false;
+				return;
+			}
+		}
+	});
+}
+
 /**
  * Update the acceptance for a station.
  * @param st Station to update
@@ -671,10 +730,14 @@ void UpdateStationAcceptance(Station *st, bool show_msg)
 	/* old accepted goods types */
 	CargoTypes old_acc = GetAcceptanceMask(st);
 
-	/* And retrieve the acceptance. */
+	/* And retrieve the acceptance, only rescanning the catchment if something in it changed. */
 	CargoArray acceptance;
 	if (!st->rect.IsEmpty()) {
-		acceptance = GetAcceptanceAroundStation(st, &st->always_accepted);
+		if (!st->catchment_acceptance_valid || st->catchment_acceptance_volatile) {
+			st->catchment_acceptance = GetAcceptanceAroundStation(st, &st->always_accepted, st->catchment_acceptance_volatile);
+			st->catchment_acceptance_valid = true;
+		}
+		acceptance = st->catchment_acceptance;
 	}
 
 	/* Adjust in case our station only accepts fewer kinds of goods */
@@ -4596,11 +4659,9 @@ static void StationHandleSmallTick(BaseStation *st)
 {
 	if ((st->facilities & FACIL_WAYPOINT) != 0 || !st->IsInUse()) return;
 
-	byte b = st->delete_ctr + 1;
-	if (b >= STATION_RATING_TICKS) b = 0;
-	st->delete_ctr = b;
-
-	if (b == 0) UpdateStationRating(Station::From(st));
+	/* Station index is included so that the rating updates are spread evenly over
+	 * the rating period, even for stations which were built or loaded at the same time. */
+	if ((_tick_counter + st->index) % STATION_RATING_TICKS == 0) UpdateStationRating(Station::From(st));
 }
 
 void UpdateAllStationRatings()
@@ -5713,4 +5774,5 @@ extern const TileTypeProcs _tile_type_station_procs = {
 	VehicleEnter_Station,       // vehicle_enter_tile_proc
 	GetFoundation_Station,      // get_foundation_proc
 	TerraformTile_Station,      // terraform_tile_proc
+	nullptr,                    // tile_loop_local_proc
 };
@@ -136,6 +136,15 @@ typedef void AddProducedCargoProc(TileIndex tile, CargoArray &produced);
 typedef bool ClickTileProc(TileIndex tile);
 typedef void AnimateTileProc(TileIndex tile);
 typedef void TileLoopProc(TileIndex tile);
+
+/**
+ * Tile callback function signature for running the periodic tile loop of a tile, for cases which only affect the tile itself.
+ * This is called from worker threads, for all tiles of a tile loop iteration before the #TileLoopProc of any of them.
+ * It may only modify the map data of the tile itself, and may not use the game random number generator or mark anything dirty.
+ * @param tile Tile to process.
+ * @return True if the tile has been processed, false if the #TileLoopProc of the tile has to be called instead. In that case the tile must be left unchanged.
+ */
+typedef bool TileLoopLocalProc(TileIndex tile);
 typedef void ChangeTileOwnerProc(TileIndex tile, Owner old_owner, Owner new_owner);
 
 /** @see VehicleEnterTileStatus to see what the return values mean */
@@ -178,6 +187,7 @@ struct TileTypeProcs {
 	VehicleEnterTileProc *vehicle_enter_tile_proc; ///< Called when a vehicle enters a tile
 	GetFoundationProc *get_foundation_proc;
 	TerraformTileProc *terraform_tile_proc;        ///< Called when a terraforming operation is about to take place
+	TileLoopLocalProc *tile_loop_local_proc;       ///< Called from the tile loop before tile_loop_proc, may be nullptr
 };
 
 extern const TileTypeProcs * const _tile_type_procs[16];
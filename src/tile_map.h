@@ -14,6 +14,7 @@
 #include "map_func.h"
 #include "core/bitmath_func.hpp"
 #include "settings_type.h"
+#include "pathfinder/water_regions.h"
 
 /**
  * Returns the height of a tile
@@ -62,6 +63,7 @@ static inline void SetTileHeight(TileIndex tile, uint height)
 	dbg_assert_msg(tile < MapSize(), "tile: 0x%X, size: 0x%X", tile, MapSize());
 	dbg_assert(height <= MAX_TILE_HEIGHT);
 	_m[tile].height = height;
+	InvalidateWaterRegionsAroundTileCorner(tile);
 }
 
 /**
@@ -142,6 +144,7 @@ static inline void SetTileType(TileIndex tile, TileType type)
 	 * the upper edges of the map are also VOID tiles. */
 	dbg_assert_msg(IsInnerTile(tile) == (type != MP_VOID), "tile: 0x%X (%d), type: %d", tile, IsInnerTile(tile), type);
 	SB(_m[tile].type, 4, 4, type);
+	InvalidateWaterRegion(tile);
 }
 
 /**
@@ -21,6 +21,7 @@
 #include "command_func.h"
 #include "industry.h"
 #include "station_base.h"
+#include "station_func.h"
 #include "station_kdtree.h"
 #include "company_base.h"
 #include "news_func.h"
@@ -53,6 +54,7 @@
 #include "zoom_func.h"
 #include "zoning.h"
 #include "scope.h"
+#include <cmath>
 
 #include "table/strings.h"
 #include "table/town_land.h"
@@ -2852,7 +2854,7 @@ static inline void ClearMakeHouseTile(TileIndex tile, Town *t, byte counter, byt
 	[[maybe_unused]] CommandCost cc = DoCommand(tile, 0, 0, DC_EXEC | DC_AUTO | DC_NO_WATER | DC_TOWN, CMD_LANDSCAPE_CLEAR);
 	assert(cc.Succeeded());
 
-	IncreaseBuildingCount(t, type);
+	IncreaseBuildingCount(t, type, tile);
 	MakeHouseTile(tile, t->index, counter, stage, type, random_bits);
 	if (HouseSpec::Get(type)->building_flags & BUILDING_IS_ANIMATED) AddAnimatedTile(tile, false);
 
@@ -2880,10 +2882,12 @@ static void MakeTownHouse(TileIndex t, Town *town, byte counter, byte stage, Hou
 	if (size & BUILDING_HAS_4_TILES) ClearMakeHouseTile(t + TileDiffXY(1, 1), town, counter, stage, ++type, random_bits);
 
 	if (!_generating_world) {
-		ForAllStationsAroundTiles(TileArea(t, (size & BUILDING_2_TILES_X) ? 2 : 1, (size & BUILDING_2_TILES_Y) ? 2 : 1), [town](Station *st, TileIndex tile) {
+		TileArea ta(t, (size & BUILDING_2_TILES_X) ? 2 : 1, (size & BUILDING_2_TILES_Y) ? 2 : 1);
+		ForAllStationsAroundTiles(ta, [town](Station *st, TileIndex tile) {
 			town->stations_near.insert(st);
 			return true;
 		});
+		InvalidateStationCatchmentAcceptance(ta);
 	}
 	if (_record_house_coords) {
 		_record_house_rect.left = std::min(_record_house_rect.left, (int)TileX(t));
@@ -3213,6 +3217,37 @@ CommandCost CmdBuildHouse(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 	return CommandCost();
 }
 
+/** House types which may be built by town growth, per side of the snow line and per house zone, in increasing order of house ID */
+static std::vector<HouseID> _town_house_candidates[2][HZB_END];
+static bool _town_house_candidates_valid = false;
+static LandscapeID _town_house_candidates_landscape;
+
+/**
+ * Get the house types which pass IsHouseTypeAllowed for town growth.
+ * The list only depends on the house specs and the climate, so is cached until the house specs are reset.
+ * @param above_snowline true to get the houses available above the snow line (arctic climate only)
+ * @param zone house zone
+ * @return house types, in increasing order of house ID
+ */
+static const std::vector<HouseID> &GetTownHouseCandidates(bool above_snowline, HouseZonesBits zone)
+{
+	if (!_town_house_candidates_valid || _town_house_candidates_landscape != _settings_game.game_creation.landscape) {
+		for (uint snow = 0; snow < 2; snow++) {
+			for (uint z = HZB_BEGIN; z < HZB_END; z++) {
+				std::vector<HouseID> &candidates = _town_house_candidates[snow][z];
+				candidates.clear();
+				for (uint i = 0; i < NUM_HOUSES; i++) {
+					if (IsHouseTypeAllowed((HouseID)i, snow != 0, (HouseZonesBits)z, false).Succeeded()) candidates.push_back((HouseID)i);
+				}
+			}
+		}
+		_town_house_candidates_valid = true;
+		_town_house_candidates_landscape = _settings_game.game_creation.landscape;
+	}
+
+	return _town_house_candidates[above_snowline ? 1 : 0][zone];
+}
+
 /**
  * Tries to build a house at this tile
  * @param t town the house will belong to
@@ -3239,14 +3274,13 @@ static bool BuildTownHouse(Town *t, TileIndex tile)
 	uint probability_max = 0;
 
 	/* Generate a list of all possible houses that can be built. */
-	for (uint i = 0; i < NUM_HOUSES; i++) {
-		if (IsHouseTypeAllowed((HouseID)i, above_snowline, zone, false).Failed()) continue;
-		if (IsAnotherHouseTypeAllowedInTown(t, (HouseID)i).Failed()) continue;
+	for (HouseID i : GetTownHouseCandidates(above_snowline, zone)) {
+		if (IsAnotherHouseTypeAllowedInTown(t, i).Failed()) continue;
 
 		uint cur_prob = HouseSpec::Get(i)->probability;
 		probability_max += cur_prob;
 		probs[num] = cur_prob;
-		houses[num++] = (HouseID)i;
+		houses[num++] = i;
 	}
 
 	TileIndex baseTile = tile;
@@ -3301,7 +3335,7 @@ static bool BuildTownHouse(Town *t, TileIndex tile)
 static void DoClearTownHouseHelper(TileIndex tile, Town *t, HouseID house)
 {
 	assert_tile(IsTileType(tile, MP_HOUSE), tile);
-	DecreaseBuildingCount(t, house);
+	DecreaseBuildingCount(t, house, tile);
 	DoClearSquare(tile);
 	DeleteAnimatedTile(tile);
 
@@ -3367,6 +3401,7 @@ void ClearTownHouse(Town *t, TileIndex tile)
 	if (hs->building_flags & BUILDING_HAS_4_TILES) DoClearTownHouseHelper(tile + TileDiffXY(1, 1), t, ++house);
 
 	RemoveNearbyStations(t, tile, hs->building_flags);
+	InvalidateStationCatchmentAcceptance(TileArea(tile, (hs->building_flags & BUILDING_2_TILES_X) ? 2 : 1, (hs->building_flags & BUILDING_2_TILES_Y) ? 2 : 1));
 
 	UpdateTownRadius(t);
 }
@@ -4624,6 +4659,7 @@ extern const TileTypeProcs _tile_type_town_procs = {
 	nullptr,                    // vehicle_enter_tile_proc
 	GetFoundation_Town,      // get_foundation_proc
 	TerraformTile_Town,      // terraform_tile_proc
+	nullptr,                 // tile_loop_local_proc
 };
 
 
@@ -4636,4 +4672,6 @@ void ResetHouses()
 
 	/* Reset any overrides that have been set. */
 	_house_mngr.ResetOverride();
+
+	_town_house_candidates_valid = false;
 }
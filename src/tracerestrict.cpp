@@ -153,6 +153,18 @@ static void HandleCondition(std::vector<TraceRestrictCondStackFlags> &condstack,
 	}
 }
 
+/**
+ * Check whether HandleCondition would use the value of a condition, or whether it only depends on the condition stack
+ */
+static bool IsConditionValueUsed(const std::vector<TraceRestrictCondStackFlags> &condstack, TraceRestrictCondFlags condflags)
+{
+	if (condflags & (TRCF_OR | TRCF_ELSE)) {
+		if ((condflags & TRCF_OR) && (condstack.back() & TRCSF_ACTIVE)) return false;
+		return !(condstack.back() & (TRCSF_DONE_IF | TRCSF_PARENT_INACTIVE));
+	}
+	return condstack.empty() || (condstack.back() & TRCSF_ACTIVE);
+}
+
 /**
  * Integer condition testing
  * Test value op condvalue
@@ -252,7 +264,9 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 	TileIndex previous_signal_tile[3];
 
 	size_t size = this->items.size();
+	const bool have_branch_targets = (this->branch_targets.size() == size);
 	for (size_t i = 0; i < size; i++) {
+		const size_t item_offset = i;
 		TraceRestrictItem item = this->items[i];
 		TraceRestrictItemType type = GetTraceRestrictType(item);
 
@@ -271,6 +285,10 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 					// end if
 					condstack.pop_back();
 				}
+			} else if (!IsConditionValueUsed(condstack, condflags)) {
+				// the result would be ignored, don't bother evaluating the condition
+				if (IsTraceRestrictDoubleItem(item)) i++;
+				HandleCondition(condstack, condflags, false);
 			} else {
 				uint16 condvalue = GetTraceRestrictValue(item);
 				bool result = false;
@@ -639,6 +657,11 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 				}
 				HandleCondition(condstack, condflags, result);
 			}
+
+			if (have_branch_targets && !(condstack.empty() || condstack.back() & TRCSF_ACTIVE) && (type != TRIT_COND_ENDIF || (condflags & TRCF_ELSE))) {
+				// the block is not active, skip to the next else/orif/elif/endif at the same level
+				i = this->branch_targets[item_offset] - 1;
+			}
 		} else {
 			if (condstack.empty() || condstack.back() & TRCSF_ACTIVE) {
 				switch(type) {
@@ -885,6 +908,46 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 	assert(condstack.empty());
 }
 
+/**
+ * Build the table of branch targets, which is used to skip over blocks which are not active.
+ * The program must already be valid.
+ */
+void TraceRestrictProgram::BuildBranchTargets()
+{
+	// static to avoid needing to re-alloc/resize on each call
+	static std::vector<size_t> block_starts;
+	block_starts.clear();
+
+	this->branch_targets.assign(this->items.size(), 0);
+
+	size_t size = this->items.size();
+	for (size_t i = 0; i < size; i++) {
+		TraceRestrictItem item = this->items[i];
+		if (IsTraceRestrictConditional(item)) {
+			TraceRestrictCondFlags condflags = GetTraceRestrictCondFlags(item);
+			if (GetTraceRestrictType(item) == TRIT_COND_ENDIF) {
+				this->branch_targets[block_starts.back()] = (uint32)i;
+				if (condflags & TRCF_ELSE) {
+					// else
+					block_starts.back() = i;
+				} else {
+					// end if
+					block_starts.pop_back();
+				}
+			} else if (condflags & (TRCF_OR | TRCF_ELSE)) {
+				// orif/elif
+				this->branch_targets[block_starts.back()] = (uint32)i;
+				block_starts.back() = i;
+			} else {
+				// if
+				block_starts.push_back(i);
+			}
+		}
+		if (IsTraceRestrictDoubleItem(item)) i++;
+	}
+	assert(block_starts.empty());
+}
+
 void TraceRestrictProgram::ClearRefIds()
 {
 	if (this->refcount > 4) free(this->ref_ids.ptr_ref_ids.buffer);
@@ -2184,6 +2247,7 @@ CommandCost CmdProgramSignalTraceRestrict(TileIndex tile, DoCommandFlag flags, u
 		// move in modified program
 		prog->items.swap(items);
 		prog->actions_used_flags = actions_used_flags;
+		prog->BuildBranchTargets();
 
 		if (prog->items.size() == 0 && prog->refcount == 1) {
 			// program is empty, and this tile is the only reference to it
@@ -2762,6 +2826,7 @@ void TraceRestrictRemoveSlotID(TraceRestrictSlotID index)
 	// update windows
 	InvalidateWindowClassesData(WC_TRACE_RESTRICT);
 	if (changed_order) {
+		for (OrderList *ol : OrderList::Iterate()) ol->InvalidateNextStoppingStationCache();
 		InvalidateWindowClassesData(WC_VEHICLE_ORDERS);
 		InvalidateWindowClassesData(WC_VEHICLE_TIMETABLE);
 	}
@@ -3019,6 +3084,7 @@ void TraceRestrictRemoveCounterID(TraceRestrictCounterID index)
 	// update windows
 	InvalidateWindowClassesData(WC_TRACE_RESTRICT);
 	if (changed_order) {
+		for (OrderList *ol : OrderList::Iterate()) ol->InvalidateNextStoppingStationCache();
 		InvalidateWindowClassesData(WC_VEHICLE_ORDERS);
 		InvalidateWindowClassesData(WC_VEHICLE_TIMETABLE);
 	}
@@ -501,6 +501,7 @@ struct TraceRestrictProgramResult {
  */
 struct TraceRestrictProgram : TraceRestrictProgramPool::PoolItem<&_tracerestrictprogram_pool> {
 	std::vector<TraceRestrictItem> items;
+	std::vector<uint32> branch_targets; ///< For each conditional item which starts or continues a block, the array offset of the next else/orif/elif/endif at the same nesting level
 	uint32 refcount;
 	TraceRestrictProgramActionsUsedFlags actions_used_flags;
 
@@ -584,10 +585,18 @@ public:
 		return items.begin() + TraceRestrictProgram::InstructionOffsetToArrayOffset(items, instruction_offset);
 	}
 
-	/** Call validation function on current program instruction list and set actions_used_flags */
+	void BuildBranchTargets();
+
+	/** Call validation function on current program instruction list and set actions_used_flags and branch_targets */
 	CommandCost Validate()
 	{
-		return TraceRestrictProgram::Validate(items, actions_used_flags);
+		CommandCost result = TraceRestrictProgram::Validate(items, actions_used_flags);
+		if (result.Succeeded()) {
+			this->BuildBranchTargets();
+		} else {
+			this->branch_targets.clear();
+		}
+		return result;
 	}
 };
 
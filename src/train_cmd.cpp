@@ -920,21 +920,41 @@ void LimitSpeedFromLookAhead(int &max_speed, const TrainDecelerationStats &stats
 	}
 }
 
+/**
+ * Get the furthest position at which a look-ahead item could still limit the speed of the train.
+ * This is the braking distance from the given speed to a stop, on the steepest descent permitted by the lowest look-ahead item.
+ * Items which are beyond this position cannot cause the train to overshoot, and so do not need their speed limits calculated.
+ * @param stats Train deceleration stats
+ * @param current_position Current position of the train on the look-ahead
+ * @param speed Highest speed which any look-ahead item can be applied to
+ * @param min_z Lower bound of the z position of the look-ahead items
+ * @return Look-ahead position beyond which items can be skipped
+ */
+static int64 GetLookAheadBrakingHorizon(const TrainDecelerationStats &stats, int current_position, int speed, int min_z)
+{
+	return current_position + GetRealisticBrakingDistanceForSpeed(stats, std::max(speed, 0), 0, std::min(min_z - stats.z_pos, 0));
+}
+
 static void ApplyLookAheadItem(const Train *v, const TrainReservationLookAheadItem &item, int &max_speed, int &advisory_max_speed,
-		VehicleOrderID &current_order_index, const Order *&order, StationID &last_station_visited, const TrainDecelerationStats &stats, int current_position)
+		VehicleOrderID &current_order_index, const Order *&order, StationID &last_station_visited, const TrainDecelerationStats &stats, int current_position, int64 horizon)
 {
 	auto limit_speed = [&](int position, int end_speed, int z) {
+		if (position > horizon) return;
 		LimitSpeedFromLookAhead(max_speed, stats, current_position, position, end_speed, z - stats.z_pos);
 		advisory_max_speed = std::min(advisory_max_speed, max_speed);
 	};
 	auto limit_advisory_speed = [&](int position, int end_speed, int z) {
+		if (position > horizon) return;
 		LimitSpeedFromLookAhead(advisory_max_speed, stats, current_position, position, end_speed, z - stats.z_pos);
 	};
 
 	switch (item.type) {
 		case TRLIT_STATION: {
 			if (order->ShouldStopAtStation(last_station_visited, item.data_id, Waypoint::GetIfValid(item.data_id) != nullptr)) {
-				limit_advisory_speed(item.start + PredictStationStoppingLocation(v, order, item.end - item.start, item.data_id), 0, item.z_pos);
+				/* The predicted stopping location is always beyond the start of the station */
+				if (item.start <= horizon) {
+					limit_advisory_speed(item.start + PredictStationStoppingLocation(v, order, item.end - item.start, item.data_id), 0, item.z_pos);
+				}
 				last_station_visited = item.data_id;
 			} else if (order->IsType(OT_GOTO_WAYPOINT) && order->GetDestination() == item.data_id && (order->GetWaypointFlags() & OWF_REVERSE)) {
 				limit_advisory_speed(item.start + v->gcache.cached_total_length, 0, item.z_pos);
@@ -1121,8 +1141,9 @@ Train::MaxSpeedInfo Train::GetCurrentMaxSpeedInfoInternal(bool update_state) con
 			VehicleOrderID current_order_index = this->cur_real_order_index;
 			const Order *order = &(this->current_order);
 			StationID last_station_visited = this->last_station_visited;
+			const int64 horizon = GetLookAheadBrakingHorizon(stats, this->lookahead->current_position, std::max(max_speed, advisory_max_speed), this->lookahead->items_min_z);
 			for (const TrainReservationLookAheadItem &item : this->lookahead->items) {
-				ApplyLookAheadItem(this, item, max_speed, advisory_max_speed, current_order_index, order, last_station_visited, stats, this->lookahead->current_position);
+				ApplyLookAheadItem(this, item, max_speed, advisory_max_speed, current_order_index, order, last_station_visited, stats, this->lookahead->current_position, horizon);
 			}
 			if (HasBit(this->lookahead->flags, TRLF_APPLY_ADVISORY)) {
 				max_speed = std::min(max_speed, advisory_max_speed);
@@ -59,6 +59,7 @@
 #include "string_func.h"
 #include "scope_info.h"
 #include "debug_settings.h"
+#include "zone_profiler.h"
 #include "3rdparty/cpp-btree/btree_set.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 
@@ -1093,6 +1094,7 @@ void Vehicle::PreDestructor()
 	if (Station::IsValidID(this->last_station_visited)) {
 		Station *st = Station::Get(this->last_station_visited);
 		st->loading_vehicles.erase(std::remove(st->loading_vehicles.begin(), st->loading_vehicles.end(), this), st->loading_vehicles.end());
+		if (st->loading_vehicles.empty()) _tick_loading_station_cache.erase(st->index);
 
 		HideFillingPercent(&this->fill_percent_te_id);
 		this->CancelReservation(INVALID_STATION, st);
@@ -1325,6 +1327,7 @@ std::vector<Vehicle *> _tick_other_veh_cache;
 
 std::vector<VehicleID> _remove_from_tick_effect_veh_cache;
 btree::btree_set<VehicleID> _tick_effect_veh_cache;
+btree::btree_set<StationID> _tick_loading_station_cache; ///< Stations with a non-empty loading_vehicles list, in index order
 
 void ClearVehicleTickCaches()
 {
@@ -1336,6 +1339,7 @@ void ClearVehicleTickCaches()
 	_tick_effect_veh_cache.clear();
 	_remove_from_tick_effect_veh_cache.clear();
 	_tick_other_veh_cache.clear();
+	_tick_loading_station_cache.clear();
 }
 
 void RemoveFromOtherVehicleTickCache(const Vehicle *v)
@@ -1381,6 +1385,9 @@ void RebuildVehicleTickCaches()
 				break;
 		}
 	}
+	for (const Station *st : Station::Iterate()) {
+		if (!st->loading_vehicles.empty()) _tick_loading_station_cache.insert(st->index);
+	}
 	_tick_caches_valid = true;
 }
 
@@ -1403,6 +1410,7 @@ void ValidateVehicleTickCaches()
 	}
 	std::vector<Vehicle *> saved_tick_other_veh_cache = std::move(_tick_other_veh_cache);
 	saved_tick_other_veh_cache.erase(std::remove(saved_tick_other_veh_cache.begin(), saved_tick_other_veh_cache.end(), nullptr), saved_tick_other_veh_cache.end());
+	btree::btree_set<StationID> saved_tick_loading_station_cache = std::move(_tick_loading_station_cache);
 
 	RebuildVehicleTickCaches();
 
@@ -1413,6 +1421,7 @@ void ValidateVehicleTickCaches()
 	assert(saved_tick_ship_cache == _tick_ship_cache);
 	assert(saved_tick_effect_veh_cache == _tick_effect_veh_cache);
 	assert(saved_tick_other_veh_cache == _tick_other_veh_cache);
+	assert(saved_tick_loading_station_cache == _tick_loading_station_cache);
 }
 
 void VehicleTickCargoAging(Vehicle *v)
@@ -1450,6 +1459,8 @@ void VehicleTickMotion(Vehicle *v, Vehicle *front)
 
 void CallVehicleTicks()
 {
+	ZONE_PROFILE("CallVehicleTicks");
+
 	_vehicles_to_autoreplace.clear();
 	_vehicles_to_templatereplace.clear();
 	_vehicles_to_pay_repair.clear();
@@ -1489,13 +1500,16 @@ void CallVehicleTicks()
 		}
 	}
 
+	if (!_tick_caches_valid || HasChickenBit(DCBF_VEH_TICK_CACHE)) RebuildVehicleTickCaches();
+
 	{
 		PerformanceMeasurer framerate(PFE_GL_ECONOMY);
+		ZONE_PROFILE("LoadUnloadStations");
 		Station *si_st = nullptr;
 		SCOPE_INFO_FMT([&si_st], "CallVehicleTicks: LoadUnloadStation: %s", scope_dumper().StationInfo(si_st));
-		for (Station *st : Station::Iterate()) {
-			si_st = st;
-			LoadUnloadStation(st);
+		for (StationID id : _tick_loading_station_cache) {
+			si_st = Station::Get(id);
+			LoadUnloadStation(si_st);
 		}
 	}
 
@@ -1516,6 +1530,7 @@ void CallVehicleTicks()
 	}
 	{
 		PerformanceMeasurer framerate(PFE_GL_TRAINS);
+		ZONE_PROFILE("Trains");
 		for (Train *t :  _tick_train_too_heavy_cache) {
 			if (HasBit(t->flags, VRF_TOO_HEAVY)) {
 				if (t->owner == _local_company) {
@@ -1539,6 +1554,7 @@ void CallVehicleTicks()
 	}
 	{
 		PerformanceMeasurer framerate(PFE_GL_ROADVEHS);
+		ZONE_PROFILE("RoadVehicles");
 		for (RoadVehicle *front : _tick_road_veh_front_cache) {
 			v = front;
 			if (!front->RoadVehicle::Tick()) continue;
@@ -1551,6 +1567,7 @@ void CallVehicleTicks()
 	}
 	{
 		PerformanceMeasurer framerate(PFE_GL_AIRCRAFT);
+		ZONE_PROFILE("Aircraft");
 		for (Aircraft *front : _tick_aircraft_front_cache) {
 			v = front;
 			if (!front->Aircraft::Tick()) continue;
@@ -1562,6 +1579,7 @@ void CallVehicleTicks()
 	}
 	{
 		PerformanceMeasurer framerate(PFE_GL_SHIPS);
+		ZONE_PROFILE("Ships");
 		for (Ship *s : _tick_ship_cache) {
 			v = s;
 			if (!s->Ship::Tick()) continue;
@@ -3418,6 +3436,7 @@ void Vehicle::LeaveStation()
 	Station *st = Station::Get(this->last_station_visited);
 	this->CancelReservation(INVALID_STATION, st);
 	st->loading_vehicles.erase(std::remove(st->loading_vehicles.begin(), st->loading_vehicles.end(), this), st->loading_vehicles.end());
+	if (st->loading_vehicles.empty()) _tick_loading_station_cache.erase(st->index);
 
 	HideFillingPercent(&this->fill_percent_te_id);
 	trip_occupancy = CalcPercentVehicleFilled(this, nullptr);
@@ -4565,6 +4584,8 @@ void DumpVehicleStats(char *buffer, const char *last)
 		buffer += seprintf(buffer, last, "\n");
 	}
 	buffer += seprintf(buffer, last, "  %10s: %5u\n", "total", (uint)Vehicle::GetNumItems());
+
+	buffer += seprintf(buffer, last, "\nRoad vehicle shared path cache: hits: " OTTD_PRINTF64U ", misses: " OTTD_PRINTF64U "\n", _rv_shared_path_cache_hits, _rv_shared_path_cache_misses);
 }
 
 void AdjustVehicleScaledTickBase(int64 delta)
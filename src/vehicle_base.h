@@ -832,9 +832,8 @@ public:
 	 */
 	inline CargoStationIDStackSet GetNextStoppingStation() const
 	{
-		CargoStationIDStackSet set;
-		if (this->orders != nullptr) set.FillNextStoppingStation(this, this->orders);
-		return set;
+		if (this->orders != nullptr) return this->orders->GetNextStoppingStationSet(this);
+		return CargoStationIDStackSet();
 	}
 
 	/**
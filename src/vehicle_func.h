@@ -20,6 +20,8 @@
 #include "track_type.h"
 #include "livery.h"
 #include "cargo_type.h"
+#include "station_type.h"
+#include "3rdparty/cpp-btree/btree_set.h"
 
 #define is_custom_sprite(x) (x >= 0xFD)
 #define IS_CUSTOM_FIRSTHEAD_SPRITE(x) (x == 0xFD)
@@ -116,6 +118,8 @@ inline bool HasVehicleOnPosXY(int x, int y, VehicleType type, void *data, Vehicl
 	return VehicleFromPosXY(x, y, type, data, proc, true) != nullptr;
 }
 
+extern btree::btree_set<StationID> _tick_loading_station_cache;
+
 void CallVehicleTicks();
 uint8 CalcPercentVehicleFilled(const Vehicle *v, StringID *colour);
 uint8 CalcPercentVehicleFilledOfCargo(const Vehicle *v, CargoID cargo);
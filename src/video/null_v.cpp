@@ -13,6 +13,9 @@
 #include "../sl/saveload.h"
 #include "../window_func.h"
 #include "../thread.h"
+#include "../framerate_type.h"
+#include "../openttd.h"
+#include "../debug.h"
 #include "null_v.h"
 
 #include <atomic>
@@ -35,6 +38,7 @@ const char *VideoDriver_Null::Start(const StringList &parm)
 
 	this->ticks = GetDriverParamInt(parm, "ticks", 1000);
 	this->until_exit = GetDriverParamBool(parm, "until_exit");
+	this->benchmark = GetDriverParamBool(parm, "benchmark");
 	_screen.width  = _screen.pitch = _cur_resolution.width;
 	_screen.height = _cur_resolution.height;
 	_screen.dst_ptr = nullptr;
@@ -59,6 +63,28 @@ void VideoDriver_Null::MainLoop()
 			::InputLoop();
 			::UpdateWindows();
 		}
+	} else if (this->benchmark) {
+		/* Load the savegame (or generate the map) before starting the measurement. */
+		while (_switch_mode != SM_NONE && !_exit_game) {
+			::GameLoop();
+			::InputLoop();
+			::UpdateWindows();
+		}
+		if (_game_mode != GM_NORMAL) {
+			DEBUG(misc, 0, "Benchmark: no game was loaded, not running benchmark");
+			return;
+		}
+
+		/* A game saved while paused would not run any ticks at all. */
+		_pause_mode = PM_UNPAUSED;
+
+		StartPerformanceRecording();
+		for (int i = 0; i < this->ticks && !_exit_game; i++) {
+			::GameLoop();
+			::InputLoop();
+			::UpdateWindows();
+		}
+		WritePerformanceRecordingJSON(stdout);
 	} else {
 		for (int i = 0; i < this->ticks; i++) {
 			::GameLoop();
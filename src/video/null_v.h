@@ -17,6 +17,7 @@ class VideoDriver_Null : public VideoDriver {
 private:
 	int ticks; ///< Amount of ticks to run.
 	bool until_exit;
+	bool benchmark; ///< Measure the ticks after loading the game and write the results as JSON to stdout.
 
 public:
 	const char *Start(const StringList &param) override;
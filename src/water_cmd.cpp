@@ -1331,6 +1331,21 @@ void TileLoop_Water(TileIndex tile)
 	TileLoopWaterFlooding(GetFloodingBehaviour(tile), tile);
 }
 
+/**
+ * Run the tile loop of a water tile, when it is known to not do anything.
+ * @param tile Tile to process.
+ * @return Whether the tile has been processed, otherwise TileLoop_Water has to be called for it.
+ */
+static bool TileLoopLocal_Water(TileIndex tile)
+{
+	if (HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK)) return false;
+
+	/* At day lengths > 4, handle flooding in auxiliary tile loop */
+	if (_settings_game.economy.day_length_factor > 4 && _game_mode != GM_EDITOR) return true;
+
+	return IsNonFloodingWaterTile(tile);
+}
+
 void TileLoopWaterFlooding(FloodingBehaviour flooding_behaviour, TileIndex tile)
 {
 	switch (flooding_behaviour) {
@@ -1515,4 +1530,5 @@ extern const TileTypeProcs _tile_type_water_procs = {
 	VehicleEnter_Water,       // vehicle_enter_tile_proc
 	GetFoundation_Water,      // get_foundation_proc
 	TerraformTile_Water,      // terraform_tile_proc
+	TileLoopLocal_Water,      // tile_loop_local_proc
 };
@@ -0,0 +1,175 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file zone_profiler.cpp Fine-grained scoped zone profiler, with Chrome trace-event export. */
+
+#include "stdafx.h"
+#include "zone_profiler.h"
+
+#ifdef WITH_ZONE_PROFILER
+
+#include "fileio_func.h"
+#include "string_func.h"
+#include "thread.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "safeguards.h"
+
+std::atomic<bool> _zone_profiler_active;
+
+/** Number of zone events kept per thread, older events are overwritten */
+static const uint ZONE_PROFILER_RING_SIZE = 1 << 17;
+
+/** One completed zone */
+struct ZoneProfilerEvent {
+	const char *name; ///< Zone name
+	uint64 start;     ///< Start time, in microseconds
+	uint64 duration;  ///< Duration, in microseconds
+};
+
+/** Ring buffer of zone events for one thread */
+struct ZoneProfilerThreadBuffer {
+	std::mutex lock;                       ///< Held whilst adding events and whilst exporting
+	uint tid;                              ///< Thread ID used in the exported trace
+	std::string thread_name;               ///< Name of the thread, buffers are reused by later threads with the same name
+	bool in_use = true;                    ///< Whether a live thread currently owns this buffer, protected by _zone_profiler_buffers_lock
+	std::vector<ZoneProfilerEvent> events; ///< Ring buffer storage
+	uint next = 0;                         ///< Next index to write to in events
+	uint count = 0;                        ///< Number of valid events, clamped to ZONE_PROFILER_RING_SIZE
+
+	void Clear()
+	{
+		std::lock_guard<std::mutex> lk(this->lock);
+		this->next = 0;
+		this->count = 0;
+	}
+};
+
+static std::mutex _zone_profiler_buffers_lock;
+static std::vector<std::unique_ptr<ZoneProfilerThreadBuffer>> _zone_profiler_buffers;
+
+/** Per-thread handle to the buffer of the current thread, which releases the buffer for reuse when the thread exits */
+struct ZoneProfilerThreadHandle {
+	ZoneProfilerThreadBuffer *buffer = nullptr;
+
+	~ZoneProfilerThreadHandle()
+	{
+		if (this->buffer == nullptr) return;
+		std::lock_guard<std::mutex> lk(_zone_profiler_buffers_lock);
+		this->buffer->in_use = false;
+	}
+};
+
+static thread_local ZoneProfilerThreadHandle _zone_profiler_thread;
+
+static uint64 GetZoneProfilerTimer()
+{
+	using namespace std::chrono;
+	return (uint64)time_point_cast<microseconds>(steady_clock::now()).time_since_epoch().count();
+}
+
+static ZoneProfilerThreadBuffer *GetZoneProfilerThreadBuffer()
+{
+	if (_zone_profiler_thread.buffer != nullptr) return _zone_profiler_thread.buffer;
+
+	char name[64];
+	if (GetCurrentThreadName(name, lastof(name)) == 0) strecpy(name, "unnamed", lastof(name));
+
+	std::lock_guard<std::mutex> lk(_zone_profiler_buffers_lock);
+	for (auto &buf : _zone_profiler_buffers) {
+		if (!buf->in_use && buf->thread_name == name) {
+			buf->in_use = true;
+			_zone_profiler_thread.buffer = buf.get();
+			return buf.get();
+		}
+	}
+
+	ZoneProfilerThreadBuffer *buf = new ZoneProfilerThreadBuffer();
+	buf->tid = (uint)_zone_profiler_buffers.size() + 1;
+	buf->thread_name = name;
+	buf->events.resize(ZONE_PROFILER_RING_SIZE);
+	_zone_profiler_buffers.emplace_back(buf);
+	_zone_profiler_thread.buffer = buf;
+	return buf;
+}
+
+void ZoneProfilerScope::Begin()
+{
+	this->start = GetZoneProfilerTimer();
+}
+
+void ZoneProfilerScope::End()
+{
+	const uint64 end = GetZoneProfilerTimer();
+	ZoneProfilerThreadBuffer *buf = GetZoneProfilerThreadBuffer();
+
+	std::lock_guard<std::mutex> lk(buf->lock);
+	buf->events[buf->next] = { this->name, this->start, end - this->start };
+	buf->next = (buf->next + 1) % ZONE_PROFILER_RING_SIZE;
+	if (buf->count < ZONE_PROFILER_RING_SIZE) buf->count++;
+}
+
+/** Discard all previously recorded zones and start recording. */
+void StartZoneProfiler()
+{
+	{
+		std::lock_guard<std::mutex> lk(_zone_profiler_buffers_lock);
+		for (auto &buf : _zone_profiler_buffers) buf->Clear();
+	}
+	_zone_profiler_active.store(true, std::memory_order_relaxed);
+}
+
+/** Stop recording zones, already recorded zones are kept for export. */
+void StopZoneProfiler()
+{
+	_zone_profiler_active.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * Write the recorded zones of all threads as a Chrome trace-event JSON file,
+ * which can be loaded in chrome://tracing, Perfetto or Speedscope.
+ * @param filename File to write.
+ * @param[out] event_count Number of zone events written.
+ * @return Whether the file could be written.
+ */
+bool ExportZoneProfilerChromeTrace(const char *filename, uint *event_count)
+{
+	FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+	if (f == nullptr) return false;
+	FileCloser fcloser(f);
+
+	*event_count = 0;
+
+	fputs("{\"traceEvents\":[", f);
+	bool first = true;
+
+	std::lock_guard<std::mutex> lk(_zone_profiler_buffers_lock);
+	for (auto &buf : _zone_profiler_buffers) {
+		std::lock_guard<std::mutex> buf_lk(buf->lock);
+
+		fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",", buf->tid, buf->thread_name.c_str());
+		first = false;
+
+		uint index = (buf->next + ZONE_PROFILER_RING_SIZE - buf->count) % ZONE_PROFILER_RING_SIZE;
+		for (uint i = 0; i < buf->count; i++) {
+			const ZoneProfilerEvent &ev = buf->events[index];
+			fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" OTTD_PRINTF64U ",\"dur\":" OTTD_PRINTF64U "}", ev.name, buf->tid, ev.start, ev.duration);
+			index = (index + 1) % ZONE_PROFILER_RING_SIZE;
+		}
+		*event_count += buf->count;
+	}
+
+	fputs("\n],\"displayTimeUnit\":\"ms\"}\n", f);
+	return true;
+}
+
+#endif /* WITH_ZONE_PROFILER */
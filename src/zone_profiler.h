@@ -0,0 +1,69 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file zone_profiler.h Fine-grained scoped zone profiler, enabled by the OPTION_ZONE_PROFILER build option. */
+
+#ifndef ZONE_PROFILER_H
+#define ZONE_PROFILER_H
+
+#ifdef WITH_ZONE_PROFILER
+
+#include <atomic>
+
+extern std::atomic<bool> _zone_profiler_active;
+
+/**
+ * RAII class recording the time spent in a named zone of code into a per-thread ring buffer.
+ * Zones may be nested, nesting is reconstructed from the timestamps when exporting.
+ * Use the ZONE_PROFILE macro instead of using this directly.
+ */
+class ZoneProfilerScope {
+	const char *name; ///< Name of the zone, must be a string literal, nullptr if the profiler was not active on entry
+	uint64 start;     ///< Start time of the zone, in microseconds
+
+	void Begin();
+	void End();
+
+public:
+	inline ZoneProfilerScope(const char *name)
+	{
+		if (_zone_profiler_active.load(std::memory_order_relaxed)) {
+			this->name = name;
+			this->Begin();
+		} else {
+			this->name = nullptr;
+		}
+	}
+
+	inline ~ZoneProfilerScope()
+	{
+		if (this->name != nullptr) this->End();
+	}
+
+	ZoneProfilerScope(const ZoneProfilerScope &copysrc) = delete;
+};
+
+void StartZoneProfiler();
+void StopZoneProfiler();
+bool ExportZoneProfilerChromeTrace(const char *filename, uint *event_count);
+
+#define ZONE_PROFILE_PASTE(a, b) a ## b
+#define ZONE_PROFILE_NAME(a, b) ZONE_PROFILE_PASTE(a, b)
+
+/**
+ * Record the remainder of the current scope as a zone with the given name, whilst the zone profiler is active.
+ * @param name Zone name, must be a string literal.
+ */
+#define ZONE_PROFILE(name) ZoneProfilerScope ZONE_PROFILE_NAME(_zone_profiler_scope_, __LINE__)(name)
+
+#else /* WITH_ZONE_PROFILER */
+
+#define ZONE_PROFILE(name) { }
+
+#endif /* WITH_ZONE_PROFILER */
+
+#endif /* ZONE_PROFILER_H */